@@ -4,13 +4,21 @@
 #ifndef MRMR_ATTRIBUTE_INFORMATION_HPP
 #define MRMR_ATTRIBUTE_INFORMATION_HPP
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <iterator>
 #include <limits>
+#include <mrmr/detail/parallel.hpp>
 #include <mrmr/typedef.hpp>
 #include <numbers>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <valarray>
+#include <vector>
 
 /**
  * @brief Computes and caches information-theoretic measures for a single attribute.
@@ -21,12 +29,12 @@
  * dataset::transpose_and_discretize. Missing values are not supported; the caller
  * must ensure complete data before construction.
  *
- * @tparam T Unsigned integer type for attribute values. Must have
- *           std::numeric_limits<T>::max() <= 255 (typically unsigned char).
+ * @tparam T Unsigned integer type for attribute values of at most 16 bits
+ *           (typically unsigned char; std::uint16_t for high-cardinality data).
  */
 template <typename T> class attribute_information {
-  static_assert(std::numeric_limits<T>::max() <= 255,
-                "attribute_information only supports types with max value <= 255");
+  static_assert(std::is_unsigned_v<T> && std::numeric_limits<T>::max() <= 65535,
+                "attribute_information only supports unsigned types of at most 16 bits");
 
 public:
   /**
@@ -43,6 +51,17 @@ public:
   template <typename ForwardIterator>
   attribute_information(ForwardIterator first, ForwardIterator last);
 
+  /**
+   * @brief Construct from a previously computed entropy and marginal distribution.
+   *
+   * Used when reloading a dataset whose attribute information was cached on
+   * disk (see dataset::load_binary), so nothing is recomputed.
+   *
+   * @param entropy Shannon entropy in bits.
+   * @param pdf     Marginal probabilities of the dense value indices [0, pdf.size()).
+   */
+  attribute_information(double entropy, std::valarray<probability> pdf);
+
   /** @brief Return the number of distinct values observed for this attribute. */
   T num_values() const;
 
@@ -58,43 +77,178 @@ public:
   probability marginal_probability(T index) const;
 
 private:
-  double _entropy;
+  template <typename U> friend class attribute_information_builder;
+
+  attribute_information() = default;
+
+  // Set the PDF and entropy from value counts summing to total.
+  template <typename Count> void set_distribution(std::span<Count const> histogram, std::size_t total);
+
+  double _entropy = 0.0;
   std::valarray<probability> _pdf;
 };
 
+/**
+ * @brief Incremental construction of attribute_information from a stream of values.
+ *
+ * Counts values as they are added, so a data source that reads an attribute
+ * through an indirection (e.g., dataset_view's instance indices) or with
+ * multiplicities (count-weighted views) needs no temporary copy of the
+ * column. build() yields exactly the attribute_information that the range
+ * constructor computes over the same multiset of values.
+ *
+ * @tparam T Unsigned integer type for attribute values, as in attribute_information.
+ */
+template <typename T> class attribute_information_builder {
+public:
+  attribute_information_builder() {
+    if constexpr (narrow) {
+      _histogram.assign(std::size_t{std::numeric_limits<T>::max()} + 1, 0);
+    }
+  }
+
+  /** @brief Add one instance with value @p value. */
+  void add(T value) { add(value, 1); }
+
+  /** @brief Add @p count instances with value @p value. */
+  void add(T value, std::size_t count) {
+    if constexpr (!narrow) {
+      if (value >= _histogram.size()) {
+        _histogram.resize(std::size_t{value} + 1, 0);
+      }
+    }
+    _histogram[value] += count;
+    _total += count;
+  }
+
+  /** @brief Return the number of instances added so far. */
+  std::size_t size() const { return _total; }
+
+  /**
+   * @brief Return the attribute_information of the values added so far.
+   *
+   * At least one value must have been added; values must be contiguous
+   * integers in [0, k), as for the range constructor.
+   */
+  attribute_information<T> build() const {
+    attribute_information<T> info;
+    info.set_distribution(std::span<std::size_t const>(_histogram), _total);
+    return info;
+  }
+
+private:
+  static constexpr bool narrow = std::numeric_limits<T>::max() <= 255;
+
+  std::vector<std::size_t> _histogram;
+  std::size_t _total = 0;
+};
+
+namespace detail {
+
+/// Multiplicity of stream_attribute_information when every instance counts once.
+struct unit_multiplicity {
+  std::size_t operator()(std::size_t /*instance*/) const { return 1; }
+};
+
+} // namespace detail
+
+/**
+ * @brief Compute the attribute_information of every attribute of a data source.
+ *
+ * Streams data(attribute, i) for every instance i through an
+ * attribute_information_builder, adding instance i multiplicity(i) times, so
+ * no attribute is copied into a temporary first. Attributes are independent
+ * and are distributed over @p num_threads threads; the result does not depend
+ * on the thread count.
+ *
+ * @tparam DataSource   Discrete data source providing value_type,
+ *                      num_attributes(), num_instances(), and
+ *                      operator()(attribute, instance).
+ * @tparam Multiplicity Callable as std::size_t(std::size_t instance).
+ * @param data         The data source.
+ * @param num_threads  Threads to use (1 = serial, 0 = hardware concurrency).
+ * @param multiplicity How many instances each instance stands for (default: 1).
+ * @return One attribute_information per attribute, in attribute order.
+ */
+template <typename DataSource, typename Multiplicity = detail::unit_multiplicity>
+std::vector<attribute_information<typename DataSource::value_type>>
+stream_attribute_information(DataSource const &data, std::size_t num_threads = 1,
+                             Multiplicity multiplicity = Multiplicity{}) {
+  using value_type = typename DataSource::value_type;
+  std::vector<attribute_information<value_type>> infos(
+      data.num_attributes(), attribute_information<value_type>(0.0, std::valarray<probability>()));
+  detail::parallel_for(num_threads, infos.size(), 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t attr = begin; attr < end; ++attr) {
+      attribute_information_builder<value_type> builder;
+      for (std::size_t inst = 0; inst < data.num_instances(); ++inst) {
+        builder.add(data(attr, inst), multiplicity(inst));
+      }
+      infos[attr] = builder.build();
+    }
+  });
+  return infos;
+}
+
 template <typename T>
 template <typename ForwardIterator>
 attribute_information<T>::attribute_information(ForwardIterator first, ForwardIterator last) {
   // determine number of elements (std::distance is correct for all iterator categories)
   auto count = static_cast<std::size_t>(std::distance(first, last));
 
-  // compute temporary histogram on fast integral type
-  std::array<unsigned int, std::numeric_limits<T>::max() + 1> temp_histogram = {};
+  // compute temporary histogram on fast integral type; 8-bit values use a fixed
+  // array, wider values a vector sized by the largest value present
+  constexpr bool narrow = std::numeric_limits<T>::max() <= 255;
+  std::array<unsigned int, narrow ? std::numeric_limits<T>::max() + 1 : 1> narrow_histogram = {};
+  std::vector<unsigned int> wide_histogram;
+  std::span<unsigned int> temp_histogram(narrow_histogram);
+  if constexpr (!narrow) {
+    if (first != last) {
+      wide_histogram.assign(std::size_t{*std::max_element(first, last)} + 1, 0);
+    }
+    temp_histogram = wide_histogram;
+  }
   while (first != last) {
     ++temp_histogram[*first];
     ++first;
   }
 
+  set_distribution(std::span<unsigned int const>(temp_histogram), count);
+}
+
+template <typename T>
+template <typename Count>
+void attribute_information<T>::set_distribution(std::span<Count const> histogram,
+                                                 std::size_t total) {
   // find non-zero values in histogram and populate storage-optimized final PDF
-  T buckets = 0;
-  for (auto it = std::cbegin(temp_histogram); it != std::cend(temp_histogram); ++it) {
-    if (*it != 0) {
+  std::size_t buckets = 0;
+  for (Count freq : histogram) {
+    if (freq != 0) {
       ++buckets;
     }
   }
   _pdf.resize(buckets);
-  std::copy_if(std::cbegin(temp_histogram), std::cend(temp_histogram), std::begin(_pdf),
-               [](unsigned int freq) { return freq != 0; });
-  _pdf = _pdf / static_cast<double>(count);
+  std::size_t bucket = 0;
+  for (Count freq : histogram) {
+    if (freq != 0) {
+      _pdf[bucket++] = static_cast<probability>(freq);
+    }
+  }
+  _pdf = _pdf / static_cast<double>(total);
 
   // compute entropy (natural-log result divided by ln(2) yields log2)
   _entropy = -1 * (_pdf * std::log(_pdf)).sum() / std::numbers::ln2;
 }
 
+template <typename T>
+attribute_information<T>::attribute_information(double entropy, std::valarray<probability> pdf)
+    : _entropy(entropy), _pdf(std::move(pdf)) {
+  assert(_pdf.size() <= std::size_t{std::numeric_limits<T>::max()} + 1);
+}
+
 template <typename T> T attribute_information<T>::num_values() const {
-  // _pdf.size() is std::size_t but T (the storage type) is constrained to
-  // hold values in [0, 255] by the static_assert in dataset.hpp. The cast
-  // is value-preserving for any well-formed instance.
+  // _pdf.size() is std::size_t but the number of distinct values of a
+  // well-formed instance fits the storage type T, so the cast is
+  // value-preserving.
   return static_cast<T>(_pdf.size());
 }
 
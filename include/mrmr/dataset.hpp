@@ -5,18 +5,34 @@
 #define MRMR_DATASET_HPP
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <locale>
+#include <memory>
 #include <mrmr/attribute_information.hpp>
+#include <mrmr/detail/binary_format.hpp>
+#include <mrmr/detail/delimited_parser.hpp>
 #include <mrmr/detail/delimiter_ctype.hpp>
+#include <mrmr/detail/mapped_file.hpp>
+#include <mrmr/detail/parallel.hpp>
 #include <mrmr/matrix.hpp>
 #include <mrmr/mi_policy.hpp>
 #include <mrmr/typedef.hpp>
+#include <span>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <valarray>
 #include <vector>
 
@@ -29,15 +45,26 @@
  * mutual information computation. Entropy and marginal probabilities are precomputed
  * and cached for all attributes.
  *
- * Input data must be complete (no missing values). This class is not thread-safe
- * for concurrent mutual_information() calls on the same instance.
+ * Input data must be complete (no missing values). const member functions,
+ * including mutual_information(), are safe to call concurrently on the same
+ * instance: the MI histogram scratch buffer is thread-local.
  *
- * @tparam T Unsigned integer storage type. Must have
- *           std::numeric_limits<T>::max() <= 255 (typically unsigned char).
+ * A dataset can be saved in a versioned binary format (save_binary) and
+ * reloaded by memory-mapping the file (load_binary). A loaded dataset reads
+ * its columns directly from the mapping and shares it with its copies.
+ *
+ * The storage type bounds the range of an attribute after discretization:
+ * unsigned char allows ranges up to 255, std::uint16_t up to 65535 (for
+ * identifiers such as ZIP codes or product IDs) at twice the memory. MI
+ * between attributes whose joint alphabet exceeds the number of instances is
+ * counted sparsely (see compute_mi).
+ *
+ * @tparam T Unsigned integer storage type of at most 16 bits (typically
+ *           unsigned char).
  */
 template <typename T> class dataset {
-  static_assert(std::numeric_limits<T>::max() <= 255,
-                "dataset only supports storage types with max value <= 255");
+  static_assert(std::is_unsigned_v<T> && std::numeric_limits<T>::max() <= 65535,
+                "dataset only supports unsigned storage types of at most 16 bits");
 
   template <typename U> friend std::ostream &operator<<(std::ostream &os, dataset<U> const &m);
   template <typename U> friend class dataset_view;
@@ -70,14 +97,41 @@ public:
    * attribute names followed by rows of numeric data, one instance per row.
    * Values are discretized according to @p dm and compacted to dense indices.
    *
-   * @param is        Input stream positioned at the beginning of the header line.
-   * @param dm        Discretization method applied to each value.
-   * @param delimiter Field separator character (default tab).
+   * @param is          Input stream positioned at the beginning of the header line.
+   * @param dm          Discretization method applied to each value.
+   * @param delimiter   Field separator character (default tab).
+   * @param ms          Missing value strategy.
+   * @param num_threads Threads used to discretize, compact, and summarize the
+   *                    attributes (0 = hardware concurrency); parsing is sequential.
    * @throws std::runtime_error If the header newline is missing or column counts
    *                            are inconsistent across rows.
    */
   dataset(std::istream &, discretization_method dm = ROUND, char delimiter = '\t',
-          missing_strategy ms = missing_strategy::ERROR);
+          missing_strategy ms = missing_strategy::ERROR, std::size_t num_threads = 1);
+
+  /**
+   * @brief Read a delimited text file, parsing it on several threads.
+   *
+   * Produces the same dataset as the stream constructor on the same file. A
+   * regular file is memory-mapped and its data rows are split at line
+   * boundaries into one chunk per thread; each chunk is parsed and discretized
+   * on its own thread, and the chunks are compacted together. Error messages
+   * report rows as in the sequential parse; if several chunks fail, the error
+   * nearest the start of the file is reported. Other files (pipes, devices)
+   * are read sequentially through the stream constructor.
+   *
+   * @param path        Delimited text file with a header line.
+   * @param dm          Discretization method applied to each value.
+   * @param delimiter   Field separator character (default tab).
+   * @param ms          Missing value strategy.
+   * @param num_threads Threads used to parse (0 = hardware concurrency).
+   * @return The dataset stored in @p path.
+   * @throws std::runtime_error If the file cannot be read or for the same
+   *                            input errors as the stream constructor.
+   */
+  static dataset load_text(std::string const &path, discretization_method dm = ROUND,
+                           char delimiter = '\t', missing_strategy ms = missing_strategy::ERROR,
+                           std::size_t num_threads = 1);
 
   /**
    * @brief Construct a dataset from an in-memory data vector.
@@ -94,13 +148,58 @@ public:
    * @param names          Attribute names; if empty, names are generated as "attr0", "attr1", ...
    * @param dm             Discretization method applied to each value.
    * @param delimiter      Field separator character used for stream output.
+   * @param num_threads    Threads used to discretize, compact, and summarize the
+   *                       attributes (0 = hardware concurrency).
    * @throws std::logic_error If data.size() != num_instances * num_attributes, or
    *                          if names is non-empty and names.size() != num_attributes.
    */
   template <typename U>
   dataset(std::vector<U> data, std::size_t num_instances, std::size_t num_attributes,
           bool column_major = false, std::vector<std::string> names = std::vector<std::string>(),
-          discretization_method dm = ROUND, char delimiter = '\t');
+          discretization_method dm = ROUND, char delimiter = '\t', std::size_t num_threads = 1);
+
+  /**
+   * @brief Copy and move operations.
+   *
+   * Owned columns are copied or moved with the dataset and re-bound to the
+   * new object's storage; a loaded binary dataset's copies share its mapping.
+   */
+  dataset(dataset const &other);
+  dataset(dataset &&other) noexcept;
+  dataset &operator=(dataset const &other);
+  dataset &operator=(dataset &&other) noexcept;
+  ~dataset() = default;
+
+  /**
+   * @brief Load a dataset written by save_binary() by memory-mapping the file.
+   *
+   * The compacted columns are used in place, without parsing or copying. Names
+   * and the cached entropies and marginal distributions are read from the file
+   * rather than recomputed. Each column is scanned once to check that its
+   * values are within the attribute's value count, since MI indexes histograms
+   * by value. The mapping lives as long as the dataset or any copy.
+   *
+   * @param path Binary dataset file.
+   * @return The dataset stored in @p path.
+   * @throws std::runtime_error If the file cannot be mapped, is not a binary
+   *                            dataset, has another version, byte order, or
+   *                            storage type size, is truncated, or holds a
+   *                            value outside its attribute's value count.
+   */
+  static dataset load_binary(std::string const &path);
+
+  /**
+   * @brief Write the dataset in the binary format read by load_binary().
+   *
+   * Stores the compacted column-major values, attribute names, and the cached
+   * entropies and marginal distributions (see detail/binary_format.hpp).
+   * The file is written as @p path + ".tmp" and renamed over @p path, so
+   * @p path may be the file this dataset was loaded from.
+   *
+   * @param path Output file; replaced if it exists.
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void save_binary(std::string const &path) const;
 
   /** @brief Return the number of instances (rows) in the dataset. */
   std::size_t num_instances() const;
@@ -112,9 +211,9 @@ public:
    * @brief Return the name of the attribute at the given index.
    *
    * @param attribute_num Attribute index in [0, num_attributes()).
-   * @return Attribute name string.
+   * @return Reference to the stored attribute name, valid while the dataset lives.
    */
-  std::string attribute_name(std::size_t attribute_num) const;
+  std::string const &attribute_name(std::size_t attribute_num) const;
 
   /**
    * @brief Return the Shannon entropy (in bits) of the given attribute.
@@ -137,6 +236,40 @@ public:
    */
   double mutual_information(std::size_t attribute1, std::size_t attribute2) const;
 
+  /**
+   * @brief Compute the mutual information between one attribute and a batch of others.
+   *
+   * Equivalent to out[c] = mutual_information(attribute, others[c]) for every c,
+   * with bit-identical results, but reads the column of @p attribute once per
+   * block of instances for a whole group of partners (see compute_mi_batch)
+   * instead of once per pair. Thread-safe for concurrent calls on the same instance.
+   *
+   * @param attribute Index of the fixed attribute in [0, num_attributes()).
+   * @param others    Indices of the partner attributes.
+   * @param out       Receives one MI value per entry of @p others.
+   * @throws std::logic_error If out.size() != others.size().
+   */
+  void mutual_information_batch(std::size_t attribute, std::span<std::size_t const> others,
+                                std::span<double> out) const;
+
+  /**
+   * @brief Compute the mutual information of every pair in a tile of attributes.
+   *
+   * out[r * cols.size() + c] receives mutual_information(rows[r], cols[c]),
+   * bit-identical to the per-pair call. Each block of instances of the up to
+   * 2 * mi_batch_width involved columns is read once for all pairs of the tile
+   * (see compute_mi_tile). When @p rows and @p cols are the same span, only
+   * pairs with r < c are computed.
+   *
+   * @param rows Row attribute indices (at most mi_batch_width).
+   * @param cols Column attribute indices (at most mi_batch_width).
+   * @param out  Receives rows.size() * cols.size() MI values, row-major.
+   * @throws std::logic_error If a side exceeds mi_batch_width or
+   *                          out.size() != rows.size() * cols.size().
+   */
+  void mutual_information_tile(std::span<std::size_t const> rows,
+                               std::span<std::size_t const> cols, std::span<double> out) const;
+
   /**
    * @brief Access a single discretized cell value.
    *
@@ -146,174 +279,448 @@ public:
    */
   T operator()(std::size_t attribute, std::size_t instance) const;
 
+  /**
+   * @brief Return a pointer to the contiguous column of an attribute.
+   *
+   * Columns are stored attribute-major, so the num_instances() values of
+   * @p attribute are adjacent in memory. Enables the vectorized joint-histogram
+   * kernels in compute_mi.
+   *
+   * @param attribute Attribute index in [0, num_attributes()).
+   * @return Pointer to the first value of the column.
+   */
+  T const *column_data(std::size_t attribute) const;
+
+  /**
+   * @brief Return the table of c * log2(c) for counts up to num_instances().
+   *
+   * compute_mi evaluates this dataset's integer joint histograms through it
+   * rather than with a log2 call per cell; values agree with the per-cell form
+   * to within detail::mi_table_tolerance. The table is built on first use,
+   * takes 8 * (num_instances() + 1) bytes, and is shared by copies of the
+   * dataset. Datasets with more than detail::xlogx_table_max_count instances
+   * have no table (nullptr) and use the per-cell form.
+   */
+  detail::xlogx_table const *xlogx() const { return _xlogx.get(); }
+
 private:
+  class column_builder;
+
+  template <typename U>
+  static itype discretize_value(U value, discretization_method dm, missing_strategy ms);
   template <typename U>
-  void transpose_and_discretize(matrix<U> const &temp, discretization_method dm,
-                                missing_strategy ms);
-  void compute_attribute_information();
+  void transpose_and_discretize(U const *values, std::size_t num_instances, bool column_major,
+                                discretization_method dm, missing_strategy ms,
+                                detail::thread_pool &pool);
+  void stream_and_discretize(std::istream &is, discretization_method dm, missing_strategy ms,
+                             detail::thread_pool &pool);
+  void parse_and_discretize(char const *first, char const *last, discretization_method dm,
+                            missing_strategy ms, detail::thread_pool &pool);
+  void read_header(std::istream &is);
+  void apply_missing_strategy(missing_strategy ms);
+  void compute_attribute_information(detail::thread_pool &pool);
+  void bind_columns();
   std::vector<std::string> _names;
   std::vector<attribute_information<T>> _attr_info;
   matrix<T> _data;
   char _delimiter;
-  bool _use_pairwise_mi;
+  bool _use_pairwise_mi = false;
+  // Column storage: points into _data, or into _mapping for a loaded binary
+  // dataset (in which case _data is empty).
+  std::shared_ptr<detail::mapped_file const> _mapping;
+  T const *_columns = nullptr;
+  std::size_t _num_instances = 0;
+  std::shared_ptr<detail::xlogx_table const> _xlogx;
 };
 
 template <typename T>
 template <typename U>
-void dataset<T>::transpose_and_discretize(matrix<U> const &temp, discretization_method dm,
-                                          missing_strategy ms) {
-  // Discretize, transpose to column-major storage, translate to non-negative values,
-  // and compact to contiguous unsigned integer indices for efficient histogram computation.
-
-  // Tag-dispatch helper for finiteness checks on floating-point types.
-  struct finite_check {
-    static bool is_nan(U, std::false_type) { return false; } // integer: never NaN
-    static bool is_nan(U value, std::true_type) {
-      return !std::isfinite(static_cast<double>(value));
-    }
-  };
-
+typename dataset<T>::itype dataset<T>::discretize_value(U value, discretization_method dm,
+                                                       missing_strategy ms) {
   // Sentinel value for missing data
   constexpr auto missing_itype_sentinel = static_cast<itype>(missing_sentinel<T>::value);
 
-  auto discretize_value = [dm, ms](U value) -> itype {
-    // Check for non-finite values (NaN/Inf)
-    if (finite_check::is_nan(value, std::is_floating_point<U>{})) {
+  // Check for non-finite values (NaN/Inf); integers are never NaN
+  if constexpr (std::is_floating_point_v<U>) {
+    if (!std::isfinite(static_cast<double>(value))) {
       if (ms == missing_strategy::ERROR) {
         throw std::runtime_error("non-finite value (NaN or Inf) encountered during discretization");
       }
       // Map NaN/Inf to missing sentinel for imputation or pairwise handling
       return missing_itype_sentinel;
     }
+  }
+
+  double rounded;
+  switch (dm) {
+  case ROUND:
+    rounded = std::round(static_cast<double>(value));
+    break;
+  case FLOOR:
+    rounded = std::floor(static_cast<double>(value));
+    break;
+  case CEILING:
+    rounded = std::ceil(static_cast<double>(value));
+    break;
+  case TRUNCATE:
+  default:
+    rounded = std::trunc(static_cast<double>(value));
+    break;
+  }
+
+  // Guard against overflow when converting to long.
+  // Note: static_cast<double>(LONG_MAX) rounds UP to 2^63 (not exactly representable),
+  // so >= is required to reject values at or above 2^63 which cannot be stored in long.
+  if (rounded >= static_cast<double>(std::numeric_limits<itype>::max()) ||
+      rounded < static_cast<double>(std::numeric_limits<itype>::min())) {
+    throw std::runtime_error("discretized value " + std::to_string(rounded) +
+                             " exceeds representable integer range");
+  }
+  return static_cast<itype>(rounded);
+}
 
-    double rounded;
-    switch (dm) {
-    case ROUND:
-      rounded = std::round(static_cast<double>(value));
-      break;
-    case FLOOR:
-      rounded = std::floor(static_cast<double>(value));
-      break;
-    case CEILING:
-      rounded = std::ceil(static_cast<double>(value));
-      break;
-    case TRUNCATE:
-    default:
-      rounded = std::trunc(static_cast<double>(value));
-      break;
+/**
+ * @brief Discretizes blocks of rows into compacted columns.
+ *
+ * Rows are appended a block at a time and each value is discretized as it
+ * arrives, so the input never has to be held in full. Until the last block
+ * the attribute minimum is unknown, so each value is stored as a provisional
+ * code: the discretized value minus the attribute's first value, modulo
+ * T::max() + 1. A representable attribute spans at most T::max() + 1
+ * consecutive integers, so once the minimum is known the code identifies the
+ * value exactly; finish() recovers value - minimum from it, checks ranges,
+ * and compacts to dense indices. Missing positions are kept in a separate
+ * bitmap because every code may be a valid value. Peak memory is about twice
+ * the compacted dataset. Consecutive row ranges can be filled concurrently by
+ * separate builders and compacted together.
+ *
+ * Attributes are independent, so appending and compacting run over blocks of
+ * attributes on the given pool. Row-major input is read in square tiles so
+ * that the strided gather into columns stays in cache.
+ */
+template <typename T> class dataset<T>::column_builder {
+public:
+  column_builder(dataset &owner, discretization_method dm, missing_strategy ms,
+                 detail::thread_pool &pool)
+      : _owner(owner), _dm(dm), _ms(ms), _pool(pool), _columns(owner.num_attributes()) {}
+
+  /** @brief Discretize @p rows rows of num_attributes() values each, row-major. */
+  template <typename U> void append_rows(U const *values, std::size_t rows) {
+    append(values, rows, _columns.size(), 1);
+  }
+
+  /**
+   * @brief Discretize @p rows rows given as num_attributes() columns of @p rows
+   *        values each, column-major.
+   */
+  template <typename U> void append_columns(U const *values, std::size_t rows) {
+    append(values, rows, 1, rows);
+  }
+
+  /** @brief Check ranges, compact every attribute into the owner's storage, and bind it. */
+  void finish() { finish(std::span<column_builder>(this, 1), _pool); }
+
+  /**
+   * @brief Like finish(), for rows split across builders of the same owner.
+   *
+   * The rows of @p parts are concatenated in order. Each part's codes are
+   * relative to its own first values; they are rebased onto the attribute
+   * minimum over all parts while compacting, so the parts are never copied.
+   */
+  static void finish(std::span<column_builder> parts, detail::thread_pool &pool) {
+    dataset &owner = parts.front()._owner;
+    std::size_t n_attr = owner.num_attributes();
+    std::size_t total_rows = 0;
+    for (auto const &part : parts) {
+      total_rows += part._num_rows;
     }
 
-    // Guard against overflow when converting to long.
-    // Note: static_cast<double>(LONG_MAX) rounds UP to 2^63 (not exactly representable),
-    // so >= is required to reject values at or above 2^63 which cannot be stored in long.
-    if (rounded >= static_cast<double>(std::numeric_limits<itype>::max()) ||
-        rounded < static_cast<double>(std::numeric_limits<itype>::min())) {
-      throw std::runtime_error("discretized value " + std::to_string(rounded) +
-                               " exceeds representable integer range");
+    // Compute ranges using unsigned arithmetic to avoid signed overflow.
+    // The range maximum - minimum could exceed LONG_MAX if values span
+    // a wide signed range (e.g., large positive and large negative values).
+    std::vector<itype> minima(n_attr, std::numeric_limits<itype>::max());
+    std::vector<utype> ranges(n_attr, 0);
+    for (std::size_t attr = 0; attr < n_attr; ++attr) {
+      itype maximum = std::numeric_limits<itype>::min();
+      for (auto const &part : parts) {
+        minima[attr] = std::min(minima[attr], part._columns[attr].minimum);
+        maximum = std::max(maximum, part._columns[attr].maximum);
+      }
+      if (minima[attr] > maximum) {
+        continue; // empty attribute (no instances)
+      }
+      // Safe unsigned subtraction: maximum >= minimum is guaranteed here
+      ranges[attr] = static_cast<utype>(maximum) - static_cast<utype>(minima[attr]);
+      if (ranges[attr] > static_cast<utype>(std::numeric_limits<T>::max())) {
+        throw std::runtime_error("attribute '" + owner.attribute_name(attr) + "' range (" +
+                                 std::to_string(ranges[attr]) + ") exceeds " +
+                                 std::to_string(static_cast<int>(std::numeric_limits<T>::max())) +
+                                 " under current discretization");
+      }
     }
-    return static_cast<itype>(rounded);
-  };
 
-  std::size_t n_inst = temp.num_rows();
-  std::size_t n_attr = num_attributes();
+    // Translate to [0, range], then compact non-contiguous values to dense
+    // contiguous indices 0..k-1. Store results in column-major _data matrix.
+    owner._data = matrix<T>(n_attr, total_rows);
+    for_attribute_blocks(pool, n_attr, [&](std::size_t attr_begin, std::size_t attr_end) {
+      for (std::size_t attr = attr_begin; attr < attr_end; ++attr) {
+        // Provisional codes are relative to each part's first value; shifting by
+        // the minimum's code in that part yields the translated value.
+        auto shift_of = [&minima, attr](column const &col) {
+          return static_cast<T>(static_cast<utype>(minima[attr]) - static_cast<utype>(col.first));
+        };
 
-  // Pass 1: Discretize all values into long intermediates, track min/max per attribute.
-  // Column-major layout (attr * n_inst + inst) for efficient per-attribute processing in pass 2.
-  std::vector<itype> discretized(n_attr * n_inst);
-  std::vector<itype> minima(n_attr, std::numeric_limits<itype>::max());
-  std::vector<itype> maxima(n_attr, std::numeric_limits<itype>::min());
+        // ranges[attr] is at most T::max(), so histogram is at most T::max() + 1 entries
+        std::size_t range_size = static_cast<std::size_t>(ranges[attr]) + 1;
 
-  for (std::size_t inst = 0; inst < n_inst; ++inst) {
-    for (std::size_t attr = 0; attr < n_attr; ++attr) {
-      itype val = discretize_value(temp(inst, attr));
-      discretized[attr * n_inst + inst] = val;
-      // Skip sentinel values in min/max tracking
-      if (val != missing_itype_sentinel) {
-        if (val < minima[attr]) {
-          minima[attr] = val;
+        // Build histogram of translated values for this attribute (skip missing)
+        std::vector<unsigned int> histogram(range_size, 0);
+        for (auto const &part : parts) {
+          auto const &col = part._columns[attr];
+          T shift = shift_of(col);
+          for (std::size_t inst = 0; inst < part._num_rows; ++inst) {
+            if (!col.is_missing(inst)) {
+              ++histogram[static_cast<T>(col.codes[inst] - shift)];
+            }
+          }
+        }
+
+        // Build rank map: maps each populated translated value to a dense index
+        std::vector<T> rank_map(range_size, 0);
+        T rank = 0;
+        for (std::size_t v = 0; v < range_size; ++v) {
+          if (histogram[v] > 0) {
+            rank_map[v] = rank++;
+          }
         }
-        if (val > maxima[attr]) {
-          maxima[attr] = val;
+
+        // Store compacted values; map missing to sentinel
+        std::size_t offset = 0;
+        for (auto &part : parts) {
+          auto &col = part._columns[attr];
+          T shift = shift_of(col);
+          for (std::size_t inst = 0; inst < part._num_rows; ++inst) {
+            owner._data(attr, offset + inst) =
+                col.is_missing(inst) ? missing_sentinel<T>::value
+                                     : rank_map[static_cast<T>(col.codes[inst] - shift)];
+          }
+          offset += part._num_rows;
+          col = column();
         }
       }
-    }
+    });
+    owner.bind_columns();
   }
 
-  // Compute ranges using unsigned arithmetic to avoid signed overflow.
-  // The range maxima[attr] - minima[attr] could exceed LONG_MAX if values span
-  // a wide signed range (e.g., large positive and large negative values).
+private:
   using utype = unsigned long;
-  std::vector<utype> ranges(n_attr, 0);
-  for (std::size_t attr = 0; attr < n_attr; ++attr) {
-    if (minima[attr] > maxima[attr]) {
-      continue; // empty attribute (no instances)
-    }
-    // Safe unsigned subtraction: maxima >= minima is guaranteed here
-    ranges[attr] = static_cast<utype>(maxima[attr]) - static_cast<utype>(minima[attr]);
-    if (ranges[attr] > static_cast<utype>(std::numeric_limits<T>::max())) {
-      throw std::runtime_error("attribute '" + attribute_name(attr) + "' range (" +
-                               std::to_string(ranges[attr]) + ") exceeds " +
-                               std::to_string(static_cast<int>(std::numeric_limits<T>::max())) +
-                               " under current discretization");
-    }
-  }
 
-  // Pass 2: Translate to [0, range], then compact non-contiguous values to dense
-  // contiguous indices 0..k-1. Store results in column-major _data matrix.
-  _data = matrix<T>(n_attr, n_inst);
+  /// Rows and attributes per tile when gathering row-major input.
+  static constexpr std::size_t tile_size = 32;
 
-  for (std::size_t attr = 0; attr < n_attr; ++attr) {
-    // ranges[attr] is at most T::max() (255), so histogram is at most 256 entries
-    std::size_t range_size = static_cast<std::size_t>(ranges[attr]) + 1;
+  /** @brief Run @p body(begin, end) over contiguous blocks of attributes on @p pool. */
+  template <typename Body>
+  static void for_attribute_blocks(detail::thread_pool &pool, std::size_t n_attr, Body &&body) {
+    pool.parallel_for(n_attr, std::max<std::size_t>(n_attr / (4 * pool.size()), 1), body);
+  }
 
-    // Build histogram of translated values for this attribute (skip missing)
-    std::vector<unsigned int> histogram(range_size, 0);
-    for (std::size_t inst = 0; inst < n_inst; ++inst) {
-      itype val = discretized[attr * n_inst + inst];
-      if (val != missing_itype_sentinel) {
-        auto translated = static_cast<std::size_t>(val - minima[attr]);
-        ++histogram[translated];
+  /** @brief Append @p rows rows; value (row, attr) is values[row * row_step + attr * attr_step]. */
+  template <typename U>
+  void append(U const *values, std::size_t rows, std::size_t row_step, std::size_t attr_step) {
+    constexpr auto missing_itype_sentinel = static_cast<itype>(missing_sentinel<T>::value);
+    for_attribute_blocks(_pool, _columns.size(), [&](std::size_t attr_begin, std::size_t attr_end) {
+      for (std::size_t attr = attr_begin; attr < attr_end; ++attr) {
+        auto &col = _columns[attr];
+        col.codes.resize(_num_rows + rows);
+        if (!col.missing.empty()) {
+          col.missing.resize(_num_rows + rows, false);
+        }
+      }
+      for (std::size_t row_tile = 0; row_tile < rows; row_tile += tile_size) {
+        std::size_t row_end = std::min(row_tile + tile_size, rows);
+        for (std::size_t attr_tile = attr_begin; attr_tile < attr_end; attr_tile += tile_size) {
+          std::size_t attr_tile_end = std::min(attr_tile + tile_size, attr_end);
+          for (std::size_t attr = attr_tile; attr < attr_tile_end; ++attr) {
+            auto &col = _columns[attr];
+            for (std::size_t row = row_tile; row < row_end; ++row) {
+              itype val = discretize_value(values[row * row_step + attr * attr_step], _dm, _ms);
+              if (val == missing_itype_sentinel) {
+                col.missing.resize(_num_rows + rows, false);
+                col.missing[_num_rows + row] = true;
+                continue;
+              }
+              if (col.minimum > col.maximum) {
+                col.first = val;
+              }
+              col.minimum = std::min(col.minimum, val);
+              col.maximum = std::max(col.maximum, val);
+              col.codes[_num_rows + row] =
+                  static_cast<T>(static_cast<utype>(val) - static_cast<utype>(col.first));
+            }
+          }
+        }
       }
+    });
+    _num_rows += rows;
+  }
+
+  struct column {
+    std::vector<T> codes;
+    std::vector<bool> missing; // empty until the attribute's first missing value
+    itype first = 0;
+    itype minimum = std::numeric_limits<itype>::max();
+    itype maximum = std::numeric_limits<itype>::min();
+
+    bool is_missing(std::size_t row) const { return !missing.empty() && missing[row]; }
+  };
+
+  dataset &_owner;
+  discretization_method _dm;
+  missing_strategy _ms;
+  detail::thread_pool &_pool;
+  std::vector<column> _columns;
+  std::size_t _num_rows = 0;
+};
+
+template <typename T>
+template <typename U>
+void dataset<T>::transpose_and_discretize(U const *values, std::size_t num_instances,
+                                          bool column_major, discretization_method dm,
+                                          missing_strategy ms, detail::thread_pool &pool) {
+  // Discretize, transpose to column-major storage, translate to non-negative values,
+  // and compact to contiguous unsigned integer indices for efficient histogram computation.
+  column_builder builder(*this, dm, ms, pool);
+  if (num_instances > 0 && num_attributes() > 0) {
+    if (column_major) {
+      builder.append_columns(values, num_instances);
+    } else {
+      builder.append_rows(values, num_instances);
     }
+  }
+  builder.finish();
+}
 
-    // Build rank map: maps each populated translated value to a dense index
-    std::vector<T> rank_map(range_size, 0);
-    T rank = 0;
-    for (std::size_t v = 0; v < range_size; ++v) {
-      if (histogram[v] > 0) {
-        rank_map[v] = rank++;
-      }
+template <typename T>
+void dataset<T>::stream_and_discretize(std::istream &is, discretization_method dm,
+                                       missing_strategy ms, detail::thread_pool &pool) {
+  // Parse and discretize one block of text at a time; only the current block
+  // is ever held as floating point. Always allow missing token parsing so the
+  // full file is read even when the strategy is ERROR (the error is reported
+  // during discretization).
+  column_builder builder(*this, dm, ms, pool);
+  detail::delimited_parser<fptype> parser(_delimiter, true);
+  std::vector<fptype> block;
+  detail::read_delimited(is, parser, block, [&](std::vector<fptype> &values) {
+    if (values.empty()) {
+      return;
+    }
+    if (parser.num_columns() != num_attributes()) {
+      throw std::runtime_error("header has " + std::to_string(num_attributes()) +
+                               " attributes but data rows have " +
+                               std::to_string(parser.num_columns()) + " columns");
     }
+    builder.append_rows(values.data(), values.size() / num_attributes());
+    values.clear();
+  });
+  builder.finish();
+}
+
+template <typename T>
+void dataset<T>::parse_and_discretize(char const *first, char const *last,
+                                      discretization_method dm, missing_strategy ms,
+                                      detail::thread_pool &pool) {
+  std::size_t n_attr = num_attributes();
+
+  // The first data row fixes the column count for every chunk, so a chunk
+  // starting with a short row reports it as inconsistent, as the sequential
+  // parse would.
+  std::size_t num_columns = 0;
+  for (char const *pos = first; pos != last && num_columns == 0;) {
+    auto const *newline =
+        static_cast<char const *>(std::memchr(pos, '\n', static_cast<std::size_t>(last - pos)));
+    char const *line_end = newline != nullptr ? newline + 1 : last;
+    detail::delimited_parser<fptype> probe(_delimiter, true);
+    std::vector<fptype> scratch;
+    probe.parse(pos, line_end, scratch);
+    num_columns = probe.num_columns();
+    pos = line_end;
+  }
+  if (num_columns != 0 && num_columns != n_attr) {
+    throw std::runtime_error("header has " + std::to_string(n_attr) +
+                             " attributes but data rows have " + std::to_string(num_columns) +
+                             " columns");
+  }
+
+  // Split into chunks of at least one parse block, cut after a newline.
+  auto size = static_cast<std::size_t>(last - first);
+  std::size_t num_chunks =
+      std::clamp<std::size_t>(size / detail::parse_block_size, 1, pool.size());
+  std::vector<char const *> bounds{first};
+  for (std::size_t c = 1; c < num_chunks; ++c) {
+    char const *cut = std::max(bounds.back(), first + size / num_chunks * c);
+    auto const *newline =
+        static_cast<char const *>(std::memchr(cut, '\n', static_cast<std::size_t>(last - cut)));
+    bounds.push_back(newline != nullptr ? newline + 1 : last);
+  }
+  bounds.push_back(last);
 
-    // Store compacted values; map missing to sentinel
-    for (std::size_t inst = 0; inst < n_inst; ++inst) {
-      itype val = discretized[attr * n_inst + inst];
-      if (val == missing_itype_sentinel) {
-        _data(attr, inst) = missing_sentinel<T>::value;
-      } else {
-        auto translated = static_cast<std::size_t>(val - minima[attr]);
-        _data(attr, inst) = rank_map[translated];
+  // Parse and discretize one chunk a block at a time; returns its row count.
+  auto ingest = [&](column_builder &builder, std::size_t chunk, std::size_t row_offset) {
+    detail::delimited_parser<fptype> parser(_delimiter, true, n_attr, row_offset);
+    std::vector<fptype> values;
+    char const *chunk_end = bounds[chunk + 1];
+    for (char const *pos = bounds[chunk]; pos != chunk_end;) {
+      char const *end = pos + std::min(detail::parse_block_size,
+                                       static_cast<std::size_t>(chunk_end - pos));
+      if (end != chunk_end) {
+        auto const *newline = static_cast<char const *>(
+            std::memchr(end, '\n', static_cast<std::size_t>(chunk_end - end)));
+        end = newline != nullptr ? newline + 1 : chunk_end;
+      }
+      parser.parse(pos, end, values);
+      if (!values.empty()) {
+        builder.append_rows(values.data(), values.size() / n_attr);
+        values.clear();
       }
+      pos = end;
     }
+    return parser.num_rows();
+  };
+
+  // Chunks already occupy the pool, so each chunk's builder runs serially.
+  detail::thread_pool serial(1);
+  std::vector<column_builder> parts;
+  parts.reserve(num_chunks);
+  for (std::size_t c = 0; c < num_chunks; ++c) {
+    parts.emplace_back(*this, dm, ms, serial);
   }
-}
+  std::vector<std::size_t> rows(num_chunks, 0);
+  std::vector<std::exception_ptr> failures(num_chunks);
+  pool.parallel_for(num_chunks, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      try {
+        rows[c] = ingest(parts[c], c, 0);
+      } catch (...) {
+        failures[c] = std::current_exception();
+      }
+    }
+  });
 
-template <typename T> void dataset<T>::compute_attribute_information() {
-  // perform basic attribute computations and cache results
-  _attr_info.reserve(num_attributes());
-  for (std::size_t attribute_num = 0; attribute_num < num_attributes(); ++attribute_num) {
-    auto attribute_begin = &_data(attribute_num, 0);
-    auto attribute_end = attribute_begin + num_instances();
-    _attr_info.emplace_back(attribute_begin, attribute_end);
+  // Row numbers are chunk-relative until the preceding chunks are counted:
+  // re-parse the first failed chunk with its offset to rethrow with file rows.
+  std::size_t row_offset = 0;
+  for (std::size_t c = 0; c < num_chunks; ++c) {
+    if (failures[c]) {
+      column_builder scratch(*this, dm, ms, serial);
+      ingest(scratch, c, row_offset);
+      std::rethrow_exception(failures[c]);
+    }
+    row_offset += rows[c];
   }
+  column_builder::finish(parts, pool);
 }
 
-template <typename T>
-dataset<T>::dataset() : _data(0, 0), _delimiter('\t'), _use_pairwise_mi(false) {}
-
-template <typename T>
-dataset<T>::dataset(std::istream &is, discretization_method dm, char delimiter, missing_strategy ms)
-    : _delimiter(delimiter), _use_pairwise_mi(ms == missing_strategy::PAIRWISE) {
+template <typename T> void dataset<T>::read_header(std::istream &is) {
   // the pointer below is managed via the library interface
   is.imbue(std::locale(is.getloc(), new delimiter_ctype(_delimiter)));
 
@@ -326,16 +733,9 @@ dataset<T>::dataset(std::istream &is, discretization_method dm, char delimiter,
   if (is.peek() != '\n') {
     throw std::runtime_error("missing required newline after header");
   }
+}
 
-  // read data matrix — always allow missing token parsing so the full file is
-  // read even when the strategy is ERROR (error is reported during discretization)
-  matrix<fptype> temp;
-  temp.set_delimiter(_delimiter);
-  temp.set_allow_missing(true);
-  is >> temp;
-
-  transpose_and_discretize(temp, dm, ms);
-
+template <typename T> void dataset<T>::apply_missing_strategy(missing_strategy ms) {
   // Apply imputation if requested (operates on compacted column-major _data)
   if (ms == missing_strategy::IMPUTE_MODE) {
     impute_mode(&_data(0, 0), num_attributes(), num_instances());
@@ -347,15 +747,53 @@ dataset<T>::dataset(std::istream &is, discretization_method dm, char delimiter,
     validate_no_missing(&_data(0, 0), num_attributes(), num_instances(), _names);
   }
   // PAIRWISE: no imputation; sentinel values remain for MI to handle
+}
+
+template <typename T> void dataset<T>::bind_columns() {
+  _num_instances = _data.num_columns();
+  _columns = _data.num_rows() == 0 || _data.num_columns() == 0 ? nullptr : &_data(0, 0);
+  if (_num_instances > detail::xlogx_table_max_count) {
+    _xlogx.reset();
+  } else if (!_xlogx || _xlogx->max_count() != _num_instances) {
+    _xlogx = std::make_shared<detail::xlogx_table const>(_num_instances);
+  }
+}
+
+template <typename T> void dataset<T>::compute_attribute_information(detail::thread_pool &pool) {
+  // perform basic attribute computations and cache results; attributes are
+  // independent, so each slot is filled in place by whichever thread owns it
+  _attr_info.assign(num_attributes(), attribute_information<T>(0.0, std::valarray<probability>()));
+  pool.parallel_for(num_attributes(), 1, [this](std::size_t begin, std::size_t end) {
+    for (std::size_t attribute_num = begin; attribute_num < end; ++attribute_num) {
+      T const *attribute_begin = column_data(attribute_num);
+      _attr_info[attribute_num] =
+          attribute_information<T>(attribute_begin, attribute_begin + num_instances());
+    }
+  });
+}
+
+template <typename T>
+dataset<T>::dataset() : _data(0, 0), _delimiter('\t'), _use_pairwise_mi(false) {}
+
+template <typename T>
+dataset<T>::dataset(std::istream &is, discretization_method dm, char delimiter, missing_strategy ms,
+                    std::size_t num_threads)
+    : _delimiter(delimiter), _use_pairwise_mi(ms == missing_strategy::PAIRWISE) {
+  read_header(is);
 
-  compute_attribute_information();
+  // read and discretize the data rows without materializing them as a matrix
+  detail::thread_pool pool(num_threads);
+  stream_and_discretize(is, dm, ms, pool);
+
+  apply_missing_strategy(ms);
+  compute_attribute_information(pool);
 }
 
 template <typename T>
 template <typename U>
 dataset<T>::dataset(std::vector<U> data, std::size_t num_instances, std::size_t num_attributes,
                     bool column_major, std::vector<std::string> names, discretization_method dm,
-                    char delimiter)
+                    char delimiter, std::size_t num_threads)
     : _names(std::move(names)), _delimiter(delimiter) {
   if (num_instances * num_attributes != data.size()) {
     throw std::logic_error("data size must equal the product of num_instances and num_attributes");
@@ -367,27 +805,283 @@ dataset<T>::dataset(std::vector<U> data, std::size_t num_instances, std::size_t
   } else if (num_attributes != _names.size()) {
     throw std::logic_error("names size must either equal num_attributes or be 0");
   }
-  matrix<T> temp(num_instances, num_attributes);
-  for (std::size_t instance_num = 0; instance_num < num_instances; ++instance_num) {
-    for (std::size_t attribute_num = 0; attribute_num < num_attributes; ++attribute_num) {
-      if (column_major) {
-        temp(instance_num, attribute_num) = data[attribute_num * num_instances + instance_num];
-      } else {
-        temp(instance_num, attribute_num) = data[instance_num * num_attributes + attribute_num];
-      }
+
+  // Values are converted to the storage type first, then gathered into
+  // columns in either layout without an intermediate transposed copy.
+  detail::thread_pool pool(num_threads);
+  if constexpr (std::is_same_v<U, T>) {
+    transpose_and_discretize(data.data(), num_instances, column_major, dm,
+                             missing_strategy::ERROR, pool);
+  } else {
+    std::vector<T> converted(data.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      converted[i] = data[i];
     }
+    transpose_and_discretize(converted.data(), num_instances, column_major, dm,
+                             missing_strategy::ERROR, pool);
   }
 
-  transpose_and_discretize(temp, dm, missing_strategy::ERROR);
+  compute_attribute_information(pool);
+}
 
-  compute_attribute_information();
+template <typename T>
+dataset<T>::dataset(dataset const &other)
+    : _names(other._names), _attr_info(other._attr_info), _data(other._data),
+      _delimiter(other._delimiter), _use_pairwise_mi(other._use_pairwise_mi),
+      _mapping(other._mapping), _columns(other._columns), _num_instances(other._num_instances),
+      _xlogx(other._xlogx) {
+  if (!_mapping) {
+    bind_columns();
+  }
 }
 
-template <typename T> std::size_t dataset<T>::num_instances() const { return _data.num_columns(); }
+template <typename T>
+dataset<T>::dataset(dataset &&other) noexcept
+    : _names(std::move(other._names)), _attr_info(std::move(other._attr_info)),
+      _data(std::move(other._data)), _delimiter(other._delimiter),
+      _use_pairwise_mi(other._use_pairwise_mi), _mapping(std::move(other._mapping)),
+      _columns(other._columns), _num_instances(other._num_instances),
+      _xlogx(std::move(other._xlogx)) {
+  if (!_mapping) {
+    bind_columns();
+  }
+}
+
+template <typename T> dataset<T> &dataset<T>::operator=(dataset const &other) {
+  if (this != &other) {
+    *this = dataset(other);
+  }
+  return *this;
+}
+
+template <typename T> dataset<T> &dataset<T>::operator=(dataset &&other) noexcept {
+  _names = std::move(other._names);
+  _attr_info = std::move(other._attr_info);
+  _data = std::move(other._data);
+  _delimiter = other._delimiter;
+  _use_pairwise_mi = other._use_pairwise_mi;
+  _mapping = std::move(other._mapping);
+  _columns = other._columns;
+  _num_instances = other._num_instances;
+  _xlogx = std::move(other._xlogx);
+  if (!_mapping) {
+    bind_columns();
+  }
+  return *this;
+}
+
+template <typename T>
+dataset<T> dataset<T>::load_text(std::string const &path, discretization_method dm,
+                                 char delimiter, missing_strategy ms, std::size_t num_threads) {
+  if (!std::filesystem::is_regular_file(path)) {
+    std::ifstream is(path);
+    if (!is) {
+      throw std::runtime_error(path + ": cannot open for reading");
+    }
+    return dataset(is, dm, delimiter, ms, num_threads);
+  }
+  detail::mapped_file mapping(path);
+  auto const *first = reinterpret_cast<char const *>(mapping.data());
+  char const *last = first + mapping.size();
+  auto const *newline = mapping.size() == 0 ? nullptr
+                                            : static_cast<char const *>(
+                                                  std::memchr(first, '\n', mapping.size()));
+
+  dataset result;
+  result._delimiter = delimiter;
+  result._use_pairwise_mi = ms == missing_strategy::PAIRWISE;
+  std::istringstream header(std::string(first, newline != nullptr ? newline + 1 : last));
+  result.read_header(header);
+  detail::thread_pool pool(num_threads);
+  result.parse_and_discretize(newline + 1, last, dm, ms, pool);
+  result.apply_missing_strategy(ms);
+  result.compute_attribute_information(pool);
+  return result;
+}
+
+template <typename T> dataset<T> dataset<T>::load_binary(std::string const &path) {
+  auto mapping = std::make_shared<detail::mapped_file const>(path);
+  std::byte const *base = mapping->data();
+  std::size_t size = mapping->size();
+  auto corrupt = [&path](std::string const &what) {
+    return std::runtime_error(path + ": " + what);
+  };
+
+  detail::binary_header header{};
+  if (size < sizeof(header)) {
+    throw corrupt("not a binary mrmr dataset");
+  }
+  std::memcpy(&header, base, sizeof(header));
+  if (header.magic != detail::binary_magic) {
+    throw corrupt("not a binary mrmr dataset");
+  }
+  if (header.byte_order != detail::binary_byte_order) {
+    throw corrupt("binary dataset was written with a different byte order");
+  }
+  if (header.version != detail::binary_version) {
+    throw corrupt("unsupported binary dataset version " + std::to_string(header.version) +
+                  " (expected " + std::to_string(detail::binary_version) + ")");
+  }
+  if (header.value_size != sizeof(T)) {
+    throw corrupt("binary dataset value size " + std::to_string(header.value_size) +
+                  " does not match storage type size " + std::to_string(sizeof(T)));
+  }
+
+  // Lay out the sections in file order, checking each against the file size
+  // without overflowing.
+  std::size_t cursor = sizeof(header);
+  auto section = [&](std::uint64_t count, std::size_t element_size) {
+    if (count > (size - cursor) / element_size) {
+      throw corrupt("truncated binary dataset");
+    }
+    std::size_t offset = cursor;
+    cursor += static_cast<std::size_t>(count) * element_size;
+    return offset;
+  };
+  std::size_t m = header.num_attributes;
+  std::size_t n = header.num_instances;
+  std::size_t entropies_at = section(m, sizeof(double));
+  std::size_t num_values_at = section(m, sizeof(std::uint64_t));
+  std::size_t pdfs_at = section(header.pdf_values, sizeof(double));
+  std::size_t name_lengths_at = section(m, sizeof(std::uint64_t));
+  std::size_t names_at = section(header.names_bytes, 1);
+  if (header.data_offset < cursor || header.data_offset > size ||
+      header.data_offset % detail::binary_data_alignment != 0 ||
+      (n != 0 && m > std::numeric_limits<std::size_t>::max() / n)) {
+    throw corrupt("corrupt binary dataset header");
+  }
+  cursor = header.data_offset;
+  std::size_t data_at = section(m * n, sizeof(T));
+
+  dataset result;
+  result._delimiter = static_cast<char>(header.delimiter);
+  result._use_pairwise_mi = header.pairwise_mi != 0;
+  result._names.reserve(m);
+  result._attr_info.reserve(m);
+  std::size_t pdf_left = header.pdf_values;
+  std::size_t names_left = header.names_bytes;
+  for (std::size_t a = 0; a < m; ++a) {
+    double entropy;
+    std::uint64_t num_values;
+    std::uint64_t name_length;
+    std::memcpy(&entropy, base + entropies_at + a * sizeof(double), sizeof(double));
+    std::memcpy(&num_values, base + num_values_at + a * sizeof(std::uint64_t),
+                sizeof(std::uint64_t));
+    std::memcpy(&name_length, base + name_lengths_at + a * sizeof(std::uint64_t),
+                sizeof(std::uint64_t));
+    if (num_values > pdf_left || num_values > std::size_t{std::numeric_limits<T>::max()} + 1 ||
+        name_length > names_left) {
+      throw corrupt("corrupt binary dataset attribute table");
+    }
+    std::valarray<probability> pdf(static_cast<std::size_t>(num_values));
+    if (num_values > 0) {
+      std::memcpy(std::begin(pdf), base + pdfs_at, pdf.size() * sizeof(double));
+    }
+    pdfs_at += pdf.size() * sizeof(double);
+    pdf_left -= pdf.size();
+    result._names.emplace_back(reinterpret_cast<char const *>(base + names_at),
+                               static_cast<std::size_t>(name_length));
+    names_at += result._names.back().size();
+    names_left -= result._names.back().size();
+
+    // MI indexes histograms by value, so every value must lie below the
+    // attribute's value count; pairwise datasets also keep the missing sentinel.
+    auto const *column = reinterpret_cast<T const *>(base + data_at) + a * n;
+    T highest = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      T value = result._use_pairwise_mi && is_missing(column[i]) ? T{0} : column[i];
+      highest = std::max(highest, value);
+    }
+    if (n != 0 && highest >= num_values) {
+      throw corrupt("binary dataset value " + std::to_string(highest) + " of attribute " +
+                    std::to_string(a) + " exceeds its " + std::to_string(num_values) +
+                    " values");
+    }
+    result._attr_info.emplace_back(entropy, std::move(pdf));
+  }
+
+  result._columns = reinterpret_cast<T const *>(base + data_at);
+  result._num_instances = n;
+  if (n <= detail::xlogx_table_max_count) {
+    result._xlogx = std::make_shared<detail::xlogx_table const>(n);
+  }
+  result._mapping = std::move(mapping);
+  return result;
+}
+
+template <typename T> void dataset<T>::save_binary(std::string const &path) const {
+  std::size_t m = num_attributes();
+  std::vector<double> entropies(m);
+  std::vector<std::uint64_t> num_values(m);
+  std::vector<std::uint64_t> name_lengths(m);
+  std::vector<double> pdfs;
+  std::string names;
+  for (std::size_t a = 0; a < m; ++a) {
+    auto const &info = _attr_info[a];
+    entropies[a] = info.entropy();
+    num_values[a] = info.num_values();
+    for (std::size_t v = 0; v < info.num_values(); ++v) {
+      pdfs.push_back(info.marginal_probability(static_cast<T>(v)));
+    }
+    name_lengths[a] = _names[a].size();
+    names += _names[a];
+  }
+
+  detail::binary_header header{};
+  header.magic = detail::binary_magic;
+  header.version = detail::binary_version;
+  header.byte_order = detail::binary_byte_order;
+  header.value_size = sizeof(T);
+  header.delimiter = static_cast<std::uint8_t>(_delimiter);
+  header.pairwise_mi = _use_pairwise_mi ? 1 : 0;
+  header.num_instances = num_instances();
+  header.num_attributes = m;
+  header.pdf_values = pdfs.size();
+  header.names_bytes = names.size();
+  std::size_t end = sizeof(header) + 3 * m * sizeof(std::uint64_t) +
+                    pdfs.size() * sizeof(double) + names.size();
+  std::size_t padding = (detail::binary_data_alignment - end % detail::binary_data_alignment) %
+                        detail::binary_data_alignment;
+  header.data_offset = end + padding;
+
+  // Write next to the target and rename over it, so @p path is replaced only
+  // once complete, and a file this dataset is mapped from stays intact while
+  // its columns are written out.
+  std::string temporary = path + ".tmp";
+  std::ofstream os(temporary, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    throw std::runtime_error(temporary + ": cannot open for writing");
+  }
+  detail::write_binary(os, &header, 1);
+  detail::write_binary(os, entropies.data(), entropies.size());
+  detail::write_binary(os, num_values.data(), num_values.size());
+  detail::write_binary(os, pdfs.data(), pdfs.size());
+  detail::write_binary(os, name_lengths.data(), name_lengths.size());
+  detail::write_binary(os, names.data(), names.size());
+  std::array<char, detail::binary_data_alignment> zeros{};
+  detail::write_binary(os, zeros.data(), padding);
+  if (m * num_instances() > 0) {
+    detail::write_binary(os, column_data(0), m * num_instances());
+  }
+  os.close();
+  std::error_code ec;
+  if (!os) {
+    std::filesystem::remove(temporary, ec);
+    throw std::runtime_error(temporary + ": write failed");
+  }
+  std::filesystem::rename(temporary, path, ec);
+  if (ec) {
+    std::filesystem::remove(temporary, ec);
+    throw std::runtime_error(path + ": " + ec.message());
+  }
+}
+
+template <typename T> std::size_t dataset<T>::num_instances() const { return _num_instances; }
 
 template <typename T> std::size_t dataset<T>::num_attributes() const { return _names.size(); }
 
-template <typename T> std::string dataset<T>::attribute_name(std::size_t attribute_num) const {
+template <typename T>
+std::string const &dataset<T>::attribute_name(std::size_t attribute_num) const {
   return _names[attribute_num];
 }
 
@@ -396,7 +1090,13 @@ template <typename T> double dataset<T>::attribute_entropy(std::size_t attribute
 }
 
 template <typename T> T dataset<T>::operator()(std::size_t attribute, std::size_t instance) const {
-  return _data(attribute, instance);
+  assert(attribute < num_attributes());
+  assert(instance < num_instances());
+  return _columns[attribute * _num_instances + instance];
+}
+
+template <typename T> T const *dataset<T>::column_data(std::size_t attribute) const {
+  return _columns + attribute * _num_instances;
 }
 
 template <typename T>
@@ -404,8 +1104,8 @@ double dataset<T>::mutual_information(std::size_t attribute1, std::size_t attrib
   if (_use_pairwise_mi) {
     // Pairwise-complete: skip instances where either attribute has sentinel value.
     // Column data pointers for the policy to check missingness.
-    T const *col1 = &_data(attribute1, 0);
-    T const *col2 = &_data(attribute2, 0);
+    T const *col1 = column_data(attribute1);
+    T const *col2 = column_data(attribute2);
     return compute_mi(*this, _attr_info.at(attribute1), _attr_info.at(attribute2), attribute1,
                       attribute2, pairwise_complete_policy<T>{col1, col2});
   }
@@ -413,6 +1113,78 @@ double dataset<T>::mutual_information(std::size_t attribute1, std::size_t attrib
                     attribute2, unweighted_policy{});
 }
 
+template <typename T>
+void dataset<T>::mutual_information_batch(std::size_t attribute,
+                                          std::span<std::size_t const> others,
+                                          std::span<double> out) const {
+  if (out.size() != others.size()) {
+    throw std::logic_error("mutual_information_batch output size must equal the number of others");
+  }
+  if (_use_pairwise_mi) {
+    // Pairwise-complete counts depend on both columns' missingness; no shared work.
+    for (std::size_t c = 0; c < others.size(); ++c) {
+      out[c] = mutual_information(attribute, others[c]);
+    }
+    return;
+  }
+  compute_mi_batch(
+      *this, _attr_info.at(attribute),
+      [this](std::size_t a) -> attribute_information<T> const & { return _attr_info.at(a); },
+      attribute, others, out, unweighted_policy{});
+}
+
+template <typename T>
+void dataset<T>::mutual_information_tile(std::span<std::size_t const> rows,
+                                         std::span<std::size_t const> cols,
+                                         std::span<double> out) const {
+  if (rows.size() > mi_batch_width || cols.size() > mi_batch_width) {
+    throw std::logic_error("mutual_information_tile sides must not exceed mi_batch_width");
+  }
+  if (out.size() != rows.size() * cols.size()) {
+    throw std::logic_error("mutual_information_tile output size must equal rows * cols");
+  }
+  if (_use_pairwise_mi) {
+    bool diagonal = rows.data() == cols.data() && rows.size() == cols.size();
+    for (std::size_t r = 0; r < rows.size(); ++r) {
+      for (std::size_t c = diagonal ? r + 1 : 0; c < cols.size(); ++c) {
+        out[r * cols.size() + c] = mutual_information(rows[r], cols[c]);
+      }
+    }
+    return;
+  }
+  compute_mi_tile(
+      *this,
+      [this](std::size_t a) -> attribute_information<T> const & { return _attr_info.at(a); },
+      rows, cols, out, unweighted_policy{});
+}
+
+/**
+ * @brief Check whether a file holds a binary dataset written by dataset::save_binary().
+ *
+ * Only the file signature is inspected; dataset::load_binary() validates the rest.
+ * Pipes and other non-regular files are reported as text without being read,
+ * so they can still be parsed afterwards.
+ *
+ * @param path File to inspect.
+ * @return true if @p path is a readable regular file that starts with the
+ *         binary dataset signature.
+ */
+inline bool is_binary_dataset(std::string const &path) { return detail::has_binary_magic(path); }
+
+/**
+ * @brief Size in bytes of the values stored in a binary dataset.
+ *
+ * Selects the storage type to load a file with: dataset<T>::load_binary()
+ * requires sizeof(T) to match. Like is_binary_dataset(), only regular files
+ * are read.
+ *
+ * @param path File to inspect.
+ * @return The header's value size, or 0 if @p path is not a binary dataset.
+ */
+inline std::size_t binary_dataset_value_size(std::string const &path) {
+  return detail::binary_value_size(path);
+}
+
 /**
  * @brief Write a dataset to an output stream.
  *
@@ -431,7 +1203,13 @@ template <typename T> std::ostream &operator<<(std::ostream &os, dataset<T> cons
       os << data._delimiter << data._names.at(i);
     }
     os << '\n';
-    matrix<T> transposed = data._data.transpose();
+    matrix<T> transposed(data.num_instances(), data.num_attributes());
+    for (std::size_t attr = 0; attr < data.num_attributes(); ++attr) {
+      T const *column = data.column_data(attr);
+      for (std::size_t inst = 0; inst < data.num_instances(); ++inst) {
+        transposed(inst, attr) = column[inst];
+      }
+    }
     transposed.set_delimiter(data._delimiter);
     transposed.write_to(os);
   }
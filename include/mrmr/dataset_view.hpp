@@ -7,13 +7,16 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <mrmr/attribute_information.hpp>
 #include <mrmr/dataset.hpp>
+#include <mrmr/detail/parallel.hpp>
 #include <mrmr/mi_policy.hpp>
 #include <mrmr/typedef.hpp>
 #include <numeric>
 #include <random>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -22,20 +25,33 @@
  * @brief Non-owning view over a dataset with instance and attribute subsetting.
  *
  * Provides the same public interface as dataset<T> for use with templated
- * algorithms (e.g., mrmr()). Accesses the parent dataset's data through
- * sorted instance indices for cache-efficient bootstrap resampling, and
- * optional attribute indices for feature subspacing. No data is copied;
- * only index vectors and recomputed attribute statistics are owned.
+ * algorithms (e.g., mrmr()). An index view, built from explicit instance
+ * indices (duplicates allowed), accesses the parent dataset's data through
+ * those indices; optional attribute indices select a feature subspace. No
+ * data is copied; only index vectors and recomputed attribute statistics are
+ * owned.
  *
- * When instance weights are provided (e.g., from bootstrap frequency counting),
- * mutual information is computed using weighted histograms via weighted_policy.
- * When no weights are provided, the unweighted integer-histogram path is used.
+ * When instance weights are provided, mutual information is computed using
+ * weighted histograms via weighted_policy. When no weights are provided, the
+ * unweighted integer-histogram path is used.
  *
  * Instance indices are sorted at construction time for cache-friendly access
  * patterns (see README.md Design Notes for benchmarking rationale).
  *
- * @warning The parent dataset must outlive the view. Destroying the parent
- *          while views exist results in undefined behavior.
+ * A count-weighted view (from_counts(), bootstrap(), stratified_bootstrap())
+ * stores one multiplicity per parent instance instead of instance indices:
+ * its instances are the parent's, and instance i stands for instance_count(i)
+ * copies. Its MI streams the parent's columns sequentially and adds each
+ * instance's multiplicity to the joint histogram (multiplicity_policy), which
+ * yields the same counts, and bit-identical MI, as the view listing every
+ * instance that many times, without an index vector or a sort.
+ *
+ * The view resolves the parent's column of every view attribute and the total
+ * instance weight once, at construction, so MI calls read the parent's
+ * storage through one column pointer and one instance index per value.
+ *
+ * @warning The parent dataset must outlive the view and must not be modified
+ *          or moved while views exist; otherwise the behavior is undefined.
  *
  * @tparam T Unsigned integer storage type matching the parent dataset.
  */
@@ -43,6 +59,9 @@ template <typename T> class dataset_view {
 public:
   using value_type = T;
 
+  /// Multiplicity type of count-weighted views.
+  using instance_count_type = std::uint8_t;
+
   /**
    * @brief Construct a view with explicit instance and attribute indices.
    *
@@ -52,12 +71,32 @@ public:
    *                          If empty, all parent attributes are included.
    * @param weights          Per-instance weights. If empty, uniform weights are assumed.
    *                          Must be same size as instance_indices if non-empty.
+   * @param num_threads      Threads used to compute attribute statistics
+   *                          (1 = serial, 0 = hardware concurrency).
    */
   dataset_view(dataset<T> const &source, std::vector<std::size_t> instance_indices,
-               std::vector<std::size_t> attribute_indices = {}, std::vector<double> weights = {});
+               std::vector<std::size_t> attribute_indices = {}, std::vector<double> weights = {},
+               std::size_t num_threads = 1);
 
-  /** @brief Return the number of instances in this view (may include duplicates). */
-  std::size_t num_instances() const { return _instance_indices.size(); }
+  /**
+   * @brief Return the number of instances in this view.
+   *
+   * Index views may list an instance several times; count-weighted views have
+   * the parent's instances (see instance_count()).
+   */
+  std::size_t num_instances() const {
+    return _counted ? _source.num_instances() : _instance_indices.size();
+  }
+
+  /**
+   * @brief Return how many copies of an instance the view stands for.
+   *
+   * @param instance View-local instance index in [0, num_instances()).
+   * @return The multiplicity of a count-weighted view, otherwise 1.
+   */
+  std::size_t instance_count(std::size_t instance) const {
+    return _counted ? _instance_counts[instance] : 1;
+  }
 
   /** @brief Return the number of attributes in this view. */
   std::size_t num_attributes() const { return _attribute_indices.size(); }
@@ -70,11 +109,11 @@ public:
    * @return The discretized value from the parent dataset.
    */
   T operator()(std::size_t attribute, std::size_t instance) const {
-    return _source((_attribute_indices[attribute]), _instance_indices[instance]);
+    return _columns[attribute][_counted ? instance : _instance_indices[instance]];
   }
 
   /** @brief Return the name of the attribute at the given view-local index. */
-  std::string attribute_name(std::size_t attribute_num) const {
+  std::string const &attribute_name(std::size_t attribute_num) const {
     return _source.attribute_name(_attribute_indices[attribute_num]);
   }
 
@@ -91,27 +130,80 @@ public:
    */
   double mutual_information(std::size_t attribute1, std::size_t attribute2) const;
 
+  /**
+   * @brief Compute mutual information between one view-local attribute and a batch of others.
+   *
+   * Equivalent to calling mutual_information(attribute, others[c]) for every c,
+   * with bit-identical results. Each block of the fixed attribute is gathered
+   * through the instance indirection once and reused for a whole group of
+   * partners (see compute_mi_batch).
+   *
+   * @throws std::logic_error If out.size() != others.size().
+   */
+  void mutual_information_batch(std::size_t attribute, std::span<std::size_t const> others,
+                                std::span<double> out) const;
+
+  /**
+   * @brief Compute mutual information for every pair in a tile of view-local attributes.
+   *
+   * Same contract as dataset::mutual_information_tile. Each block of
+   * instances of every attribute in the tile is gathered through the instance
+   * indirection once into an L1/L2-resident buffer and reused by all pairs of
+   * the tile, amortizing the gather over up to mi_batch_width^2 pairs.
+   *
+   * @throws std::logic_error If a side exceeds mi_batch_width or
+   *                          out.size() != rows.size() * cols.size().
+   */
+  void mutual_information_tile(std::span<std::size_t const> rows,
+                               std::span<std::size_t const> cols, std::span<double> out) const;
+
   // --- Static factory methods for common view construction patterns ---
 
+  /**
+   * @brief Create a count-weighted view.
+   *
+   * @param source            Parent dataset (must outlive this view).
+   * @param instance_counts   Multiplicity of every parent instance.
+   * @param attribute_indices Attribute indices into the parent (no duplicates).
+   *                          If empty, all parent attributes are included.
+   * @param num_threads       Threads used to compute attribute statistics
+   *                          (1 = serial, 0 = hardware concurrency).
+   * @throws std::logic_error If instance_counts.size() != source.num_instances().
+   */
+  static dataset_view from_counts(dataset<T> const &source,
+                                  std::vector<instance_count_type> instance_counts,
+                                  std::vector<std::size_t> attribute_indices = {},
+                                  std::size_t num_threads = 1);
+
   /**
    * @brief Create a bootstrap resample view (sampling with replacement).
    *
-   * @param source Parent dataset.
-   * @param gen    Random number generator.
-   * @return A view with N randomly sampled instance indices (with replacement).
+   * Draws N parent instances and counts how often each was drawn, so the view
+   * is count-weighted. Should one instance be drawn more often than
+   * instance_count_type can count, the view lists the draws as instance
+   * indices instead; either way it stands for the same sample.
+   *
+   * @param source      Parent dataset.
+   * @param gen         Random number generator.
+   * @param num_threads Threads used to compute attribute statistics
+   *                    (1 = serial, 0 = hardware concurrency).
+   * @return A view of N instances sampled with replacement.
    */
-  static dataset_view bootstrap(dataset<T> const &source, std::mt19937 &gen);
+  static dataset_view bootstrap(dataset<T> const &source, std::mt19937 &gen,
+                                std::size_t num_threads = 1);
 
   /**
    * @brief Create a stratified bootstrap view preserving class distribution.
    *
-   * @param source     Parent dataset.
-   * @param class_attr Index of the class attribute in the parent dataset.
-   * @param gen        Random number generator.
-   * @return A view with N stratified-sampled instance indices.
+   * @param source      Parent dataset.
+   * @param class_attr  Index of the class attribute in the parent dataset.
+   * @param gen         Random number generator.
+   * @param num_threads Threads used to compute attribute statistics
+   *                    (1 = serial, 0 = hardware concurrency).
+   * @return A view of N stratified-sampled instances, count-weighted as in bootstrap().
    */
   static dataset_view stratified_bootstrap(dataset<T> const &source, std::size_t class_attr,
-                                           std::mt19937 &gen);
+                                           std::mt19937 &gen, std::size_t num_threads = 1);
 
   /**
    * @brief Create a feature subspace view (random attribute subset).
@@ -119,18 +211,66 @@ public:
    * @param source       Parent dataset.
    * @param num_features Number of attributes to randomly select.
    * @param gen          Random number generator.
+   * @param num_threads  Threads used to compute attribute statistics
+   *                     (1 = serial, 0 = hardware concurrency).
    * @return A view with all instances but only num_features attributes.
    */
   static dataset_view subspace(dataset<T> const &source, std::size_t num_features,
-                               std::mt19937 &gen);
+                               std::mt19937 &gen, std::size_t num_threads = 1);
 
 private:
-  void compute_attribute_information();
+  // Data sources handed to the MI engines: view-local attributes over the
+  // parent's storage, through the instance indices or, for count-weighted
+  // views, directly (contiguous parent columns).
+  struct indexed_columns {
+    using value_type = T;
+    dataset_view const &view;
+    std::size_t num_attributes() const { return view._attribute_indices.size(); }
+    std::size_t num_instances() const { return view._instance_indices.size(); }
+    T operator()(std::size_t attribute, std::size_t instance) const {
+      return view._columns[attribute][view._instance_indices[instance]];
+    }
+    T const *source_column(std::size_t attribute) const { return view._columns[attribute]; }
+    std::size_t const *instance_index_data() const { return view._instance_indices.data(); }
+  };
+  struct counted_columns {
+    using value_type = T;
+    dataset_view const &view;
+    std::size_t num_attributes() const { return view._attribute_indices.size(); }
+    std::size_t num_instances() const { return view._source.num_instances(); }
+    T operator()(std::size_t attribute, std::size_t instance) const {
+      return view._columns[attribute][instance];
+    }
+    T const *column_data(std::size_t attribute) const { return view._columns[attribute]; }
+  };
+
+  struct counted_tag {};
+
+  dataset_view(counted_tag, dataset<T> const &source,
+               std::vector<instance_count_type> instance_counts,
+               std::vector<std::size_t> attribute_indices, std::size_t num_threads);
+
+  // Calls mi(columns, policy) with the MI data source and accumulation policy
+  // of this view.
+  template <typename MI> decltype(auto) with_mi_source(MI &&mi) const;
+
+  // Count-weighted view of the draw() results of num_draws draws, or an index
+  // view if an instance is drawn more often than instance_count_type counts.
+  template <typename Draw>
+  static dataset_view count_draws(dataset<T> const &source, std::size_t num_draws, Draw &&draw,
+                                  std::size_t num_threads);
+
+  void resolve_columns();
+  void compute_attribute_information(std::size_t num_threads);
 
   dataset<T> const &_source;
+  bool _counted = false;
   std::vector<std::size_t> _instance_indices;
+  std::vector<instance_count_type> _instance_counts;
   std::vector<std::size_t> _attribute_indices;
   std::vector<double> _weights;
+  double _total_weight = 0; // sum of _weights, in their stored order
+  std::vector<T const *> _columns; // parent column of each view attribute
   std::vector<attribute_information<T>> _attr_info;
 };
 
@@ -141,7 +281,7 @@ private:
 template <typename T>
 dataset_view<T>::dataset_view(dataset<T> const &source, std::vector<std::size_t> instance_indices,
                               std::vector<std::size_t> attribute_indices,
-                              std::vector<double> weights)
+                              std::vector<double> weights, std::size_t num_threads)
     : _source(source), _instance_indices(std::move(instance_indices)),
       _attribute_indices(std::move(attribute_indices)), _weights(std::move(weights)) {
   // Default: all attributes if none specified
@@ -177,19 +317,61 @@ dataset_view<T>::dataset_view(dataset<T> const &source, std::vector<std::size_t>
     }
   }
 
-  compute_attribute_information();
+  for (auto w : _weights) {
+    _total_weight += w;
+  }
+  resolve_columns();
+  compute_attribute_information(num_threads);
 }
 
-template <typename T> void dataset_view<T>::compute_attribute_information() {
-  _attr_info.reserve(num_attributes());
-  for (std::size_t attr = 0; attr < num_attributes(); ++attr) {
-    // Gather attribute values through the instance index indirection
-    std::vector<T> values(num_instances());
-    for (std::size_t inst = 0; inst < num_instances(); ++inst) {
-      values[inst] = (*this)(attr, inst);
-    }
-    _attr_info.emplace_back(values.begin(), values.end());
+template <typename T>
+dataset_view<T>::dataset_view(counted_tag, dataset<T> const &source,
+                              std::vector<instance_count_type> instance_counts,
+                              std::vector<std::size_t> attribute_indices, std::size_t num_threads)
+    : _source(source), _counted(true), _instance_counts(std::move(instance_counts)),
+      _attribute_indices(std::move(attribute_indices)) {
+  if (_instance_counts.size() != source.num_instances()) {
+    throw std::logic_error("instance_counts size must match the source's num_instances");
   }
+  if (_attribute_indices.empty()) {
+    _attribute_indices.resize(source.num_attributes());
+    std::iota(_attribute_indices.begin(), _attribute_indices.end(), 0);
+  }
+  resolve_columns();
+  compute_attribute_information(num_threads);
+}
+
+template <typename T> void dataset_view<T>::resolve_columns() {
+  _columns.resize(_attribute_indices.size());
+  for (std::size_t attr = 0; attr < _attribute_indices.size(); ++attr) {
+    _columns[attr] = _source.column_data(_attribute_indices[attr]);
+  }
+}
+
+template <typename T> void dataset_view<T>::compute_attribute_information(std::size_t num_threads) {
+  // Stream each attribute through the instance indirection, or over the
+  // parent column with each instance's multiplicity; nothing is gathered.
+  if (_counted) {
+    instance_count_type const *counts = _instance_counts.data();
+    _attr_info = stream_attribute_information(
+        counted_columns{*this}, num_threads,
+        [counts](std::size_t inst) -> std::size_t { return counts[inst]; });
+  } else {
+    _attr_info = stream_attribute_information(indexed_columns{*this}, num_threads);
+  }
+}
+
+template <typename T>
+template <typename MI>
+decltype(auto) dataset_view<T>::with_mi_source(MI &&mi) const {
+  if (_counted) {
+    return mi(counted_columns{*this},
+              multiplicity_policy<instance_count_type>{_instance_counts.data()});
+  }
+  if (_weights.empty()) {
+    return mi(indexed_columns{*this}, unweighted_policy{});
+  }
+  return mi(indexed_columns{*this}, weighted_policy{_weights.data(), _total_weight});
 }
 
 template <typename T>
@@ -203,36 +385,99 @@ double dataset_view<T>::mutual_information(std::size_t attribute1, std::size_t a
   auto const &src_info1 = _source._attr_info[src_attr1];
   auto const &src_info2 = _source._attr_info[src_attr2];
 
-  if (_weights.empty()) {
-    return compute_mi(*this, src_info1, src_info2, attribute1, attribute2, unweighted_policy{});
-  } else {
-    double total_weight = 0;
-    for (auto w : _weights) {
-      total_weight += w;
-    }
-    return compute_mi(*this, src_info1, src_info2, attribute1, attribute2,
-                      weighted_policy{_weights.data(), total_weight});
+  return with_mi_source([&](auto const &columns, auto const &policy) {
+    return compute_mi(columns, src_info1, src_info2, attribute1, attribute2, policy);
+  });
+}
+
+template <typename T>
+void dataset_view<T>::mutual_information_batch(std::size_t attribute,
+                                               std::span<std::size_t const> others,
+                                               std::span<double> out) const {
+  if (out.size() != others.size()) {
+    throw std::logic_error("mutual_information_batch output size must equal the number of others");
+  }
+  // Source attribute_information for histogram sizing, as in mutual_information().
+  auto const &src_info = _source._attr_info[_attribute_indices[attribute]];
+  auto info_of = [this](std::size_t a) -> attribute_information<T> const & {
+    return _source._attr_info[_attribute_indices[a]];
+  };
+
+  with_mi_source([&](auto const &columns, auto const &policy) {
+    compute_mi_batch(columns, src_info, info_of, attribute, others, out, policy);
+  });
+}
+
+template <typename T>
+void dataset_view<T>::mutual_information_tile(std::span<std::size_t const> rows,
+                                              std::span<std::size_t const> cols,
+                                              std::span<double> out) const {
+  if (rows.size() > mi_batch_width || cols.size() > mi_batch_width) {
+    throw std::logic_error("mutual_information_tile sides must not exceed mi_batch_width");
   }
+  if (out.size() != rows.size() * cols.size()) {
+    throw std::logic_error("mutual_information_tile output size must equal rows * cols");
+  }
+  auto info_of = [this](std::size_t a) -> attribute_information<T> const & {
+    return _source._attr_info[_attribute_indices[a]];
+  };
+
+  with_mi_source([&](auto const &columns, auto const &policy) {
+    compute_mi_tile(columns, info_of, rows, cols, out, policy);
+  });
 }
 
 // --- Static factories ---
 
 template <typename T>
-dataset_view<T> dataset_view<T>::bootstrap(dataset<T> const &source, std::mt19937 &gen) {
+dataset_view<T> dataset_view<T>::from_counts(dataset<T> const &source,
+                                             std::vector<instance_count_type> instance_counts,
+                                             std::vector<std::size_t> attribute_indices,
+                                             std::size_t num_threads) {
+  return dataset_view<T>(counted_tag{}, source, std::move(instance_counts),
+                         std::move(attribute_indices), num_threads);
+}
+
+template <typename T>
+template <typename Draw>
+dataset_view<T> dataset_view<T>::count_draws(dataset<T> const &source, std::size_t num_draws,
+                                             Draw &&draw, std::size_t num_threads) {
+  std::vector<instance_count_type> counts(source.num_instances(), 0);
+  for (std::size_t d = 0; d < num_draws; ++d) {
+    std::size_t inst = draw();
+    if (counts[inst] == std::numeric_limits<instance_count_type>::max()) {
+      // Too many copies to count: list the draws so far and the rest instead.
+      std::vector<std::size_t> indices;
+      indices.reserve(num_draws);
+      for (std::size_t i = 0; i < counts.size(); ++i) {
+        indices.insert(indices.end(), counts[i], i);
+      }
+      indices.push_back(inst);
+      for (++d; d < num_draws; ++d) {
+        indices.push_back(draw());
+      }
+      return dataset_view<T>(source, std::move(indices), {}, {}, num_threads);
+    }
+    ++counts[inst];
+  }
+  return dataset_view<T>(counted_tag{}, source, std::move(counts), {}, num_threads);
+}
+
+template <typename T>
+dataset_view<T> dataset_view<T>::bootstrap(dataset<T> const &source, std::mt19937 &gen,
+                                           std::size_t num_threads) {
   if (source.num_instances() == 0) {
-    return dataset_view<T>(source, {});
+    return dataset_view<T>(source, {}, {}, {}, num_threads);
   }
   std::uniform_int_distribution<std::size_t> dist(0, source.num_instances() - 1);
-  std::vector<std::size_t> indices(source.num_instances());
-  for (auto &idx : indices) {
-    idx = dist(gen);
-  }
-  return dataset_view<T>(source, std::move(indices));
+  return count_draws(
+      source, source.num_instances(), [&] { return dist(gen); }, num_threads);
 }
 
 template <typename T>
 dataset_view<T> dataset_view<T>::stratified_bootstrap(dataset<T> const &source,
-                                                      std::size_t class_attr, std::mt19937 &gen) {
+                                                      std::size_t class_attr, std::mt19937 &gen,
+                                                      std::size_t num_threads) {
   // Group instances by class value, using the actual number of distinct values
   std::size_t num_classes = source._attr_info[class_attr].num_values();
   if (num_classes == 0) {
@@ -243,25 +488,27 @@ dataset_view<T> dataset_view<T>::stratified_bootstrap(dataset<T> const &source,
     class_instances[source(class_attr, i)].push_back(i);
   }
 
-  // Sample proportionally from each class
-  std::vector<std::size_t> indices;
-  indices.reserve(source.num_instances());
-  for (auto const &group : class_instances) {
-    if (group.empty()) {
-      continue;
+  // Sample proportionally from each class: group.size() draws from each
+  // non-empty group, group by group
+  std::size_t group = 0;
+  std::size_t drawn = 0;
+  std::uniform_int_distribution<std::size_t> dist;
+  auto draw = [&] {
+    while (drawn == class_instances[group].size()) {
+      ++group;
+      drawn = 0;
     }
-    std::uniform_int_distribution<std::size_t> dist(0, group.size() - 1);
-    for (std::size_t i = 0; i < group.size(); ++i) {
-      indices.push_back(group[dist(gen)]);
+    if (drawn++ == 0) {
+      dist = std::uniform_int_distribution<std::size_t>(0, class_instances[group].size() - 1);
     }
-  }
-
-  return dataset_view<T>(source, std::move(indices));
+    return class_instances[group][dist(gen)];
+  };
+  return count_draws(source, source.num_instances(), draw, num_threads);
 }
 
 template <typename T>
 dataset_view<T> dataset_view<T>::subspace(dataset<T> const &source, std::size_t num_features,
-                                          std::mt19937 &gen) {
+                                          std::mt19937 &gen, std::size_t num_threads) {
   if (num_features > source.num_attributes()) {
     throw std::logic_error("num_features exceeds num_attributes");
   }
@@ -277,7 +524,8 @@ dataset_view<T> dataset_view<T>::subspace(dataset<T> const &source, std::size_t
   std::vector<std::size_t> all_instances(source.num_instances());
   std::iota(all_instances.begin(), all_instances.end(), 0);
 
-  return dataset_view<T>(source, std::move(all_instances), std::move(all_attrs));
+  return dataset_view<T>(source, std::move(all_instances), std::move(all_attrs), {},
+                         num_threads);
 }
 
 #endif
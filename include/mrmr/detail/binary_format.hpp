@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_DETAIL_BINARY_FORMAT_HPP
+#define MRMR_DETAIL_BINARY_FORMAT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+namespace detail {
+
+/*
+ * On-disk layout of a binary dataset (dataset::save_binary / load_binary).
+ * All integers and doubles are in the byte order of the writer, recorded in
+ * binary_header::byte_order; readers reject foreign byte orders. Every
+ * section starts at an offset that is a multiple of its element size, and the
+ * column data starts on a binary_data_alignment boundary, so a page-aligned
+ * mapping of the file can be used in place.
+ *
+ *   binary_header                 64 bytes
+ *   double   entropies[M]
+ *   uint64_t num_values[M]        marginal PDF length of each attribute
+ *   double   pdfs[sum num_values] marginal PDFs, concatenated
+ *   uint64_t name_lengths[M]
+ *   char     names[names_bytes]   concatenated, not terminated
+ *   zero padding to data_offset
+ *   T        columns[M * N]       compacted values, attribute-major
+ */
+
+/// File signature of a binary dataset.
+inline constexpr std::array<char, 8> binary_magic = {'M', 'R', 'M', 'R', 'D', 'S', 'E', 'T'};
+
+/// Layout version written by this library. Readers reject other versions.
+inline constexpr std::uint32_t binary_version = 1;
+
+/// Written as a native integer; reads back differently on a foreign byte order.
+inline constexpr std::uint32_t binary_byte_order = 0x01020304;
+
+/// Alignment of the column data section (one cache line).
+inline constexpr std::size_t binary_data_alignment = 64;
+
+struct binary_header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t value_size;
+  std::uint8_t delimiter;
+  std::uint8_t pairwise_mi;
+  std::uint16_t reserved;
+  std::uint64_t num_instances;
+  std::uint64_t num_attributes;
+  std::uint64_t pdf_values;
+  std::uint64_t names_bytes;
+  std::uint64_t data_offset;
+};
+static_assert(sizeof(binary_header) == 64 && std::is_trivially_copyable_v<binary_header>,
+              "binary_header must have a fixed 64-byte layout");
+
+/// Write the object representation of @p count trivially copyable values.
+template <typename T> void write_binary(std::ofstream &os, T const *values, std::size_t count) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  os.write(reinterpret_cast<char const *>(values),
+           static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+/// True if @p path is a regular file that starts with binary_magic. Other
+/// files are never read, since probing a pipe would consume its input.
+inline bool has_binary_magic(std::string const &path) {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return false;
+  }
+  std::ifstream is(path, std::ios::binary);
+  std::array<char, binary_magic.size()> head{};
+  return is.read(head.data(), static_cast<std::streamsize>(head.size())) &&
+         std::memcmp(head.data(), binary_magic.data(), head.size()) == 0;
+}
+
+/// Stored value size of the binary dataset at @p path, or 0 if @p path is not
+/// a regular file with a complete binary_header.
+inline std::size_t binary_value_size(std::string const &path) {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return 0;
+  }
+  std::ifstream is(path, std::ios::binary);
+  binary_header header{};
+  if (!is.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      header.magic != binary_magic) {
+    return 0;
+  }
+  return header.value_size;
+}
+
+} // namespace detail
+
+#endif
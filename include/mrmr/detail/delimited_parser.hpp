@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_DETAIL_DELIMITED_PARSER_HPP
+#define MRMR_DETAIL_DELIMITED_PARSER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace detail {
+
+/// Bytes read from the input stream per block.
+inline constexpr std::size_t parse_block_size = std::size_t{1} << 20;
+
+/// Tokens read as missing values (NaN) when missing values are allowed.
+inline bool is_missing_token(std::string_view token) {
+  return token.empty() || token == "NA" || token == "NaN" || token == "nan" || token == "?";
+}
+
+/**
+ * @brief Convert the decimal number at the start of [first, last) with std::from_chars.
+ *
+ * Accepts an optional '+' or '-' sign (std::from_chars itself rejects '+')
+ * followed by a number starting with a digit or '.', as stream extraction
+ * does; "inf" and "nan" spellings are not numbers here. Out-of-range values
+ * are rejected.
+ *
+ * @return One past the last character of the number, or @p first if no
+ *         number starts at @p first.
+ */
+template <typename T> char const *parse_number(char const *first, char const *last, T &value) {
+  char const *start = first;
+  if (start != last && *start == '+') {
+    ++start;
+  }
+  char const *digits = start != last && *start == '-' && start == first ? start + 1 : start;
+  if (digits == last || !((*digits >= '0' && *digits <= '9') || *digits == '.')) {
+    return first;
+  }
+  auto [end, ec] = std::from_chars(start, last, value);
+  return ec == std::errc{} ? end : first;
+}
+
+/**
+ * @brief Incremental parser for delimited numeric text, one block of lines at a time.
+ *
+ * Lines are located with memchr and each field is converted in place with
+ * std::from_chars, which also finds the end of the field; only fields that are
+ * not numbers are searched for the next delimiter. Row numbers in error
+ * messages count non-blank data lines from 1, after a row offset given when
+ * the input is one piece of a larger file. Blank lines are skipped, spaces and
+ * tabs (other than the delimiter) before a field are ignored, and a trailing
+ * carriage return is ignored.
+ *
+ * @tparam T Value type produced for each field.
+ */
+template <typename T> class delimited_parser {
+public:
+  /**
+   * @param delimiter     Field separator.
+   * @param allow_missing If true (floating-point T only), fields holding a
+   *                      missing token (NA, NaN, nan, ?, or empty) become NaN.
+   * @param num_columns   Required columns per row, or 0 to take the count of the first row.
+   * @param row_offset    Data rows preceding this input, added to row numbers in messages.
+   */
+  delimited_parser(char delimiter, bool allow_missing, std::size_t num_columns = 0,
+                   std::size_t row_offset = 0)
+      : _delimiter(delimiter), _allow_missing(allow_missing && std::is_floating_point_v<T>),
+        _num_columns(num_columns), _row_offset(row_offset) {}
+
+  /**
+   * @brief Parse the lines in [first, last), appending values to @p out in row-major order.
+   *
+   * The range must end at a line boundary or at the end of the input.
+   *
+   * @throws std::runtime_error If a field is not a number or missing token,
+   *                            a number is followed by something other than a
+   *                            delimiter, or a row has a different number of
+   *                            columns than required.
+   */
+  void parse(char const *first, char const *last, std::vector<T> &out) {
+    while (first != last) {
+      auto const *newline = static_cast<char const *>(
+          std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+      char const *line_end = newline != nullptr ? newline : last;
+      parse_line(first, line_end, out);
+      first = newline != nullptr ? newline + 1 : last;
+    }
+  }
+
+  /** @brief Number of data rows parsed so far. */
+  std::size_t num_rows() const { return _num_rows; }
+
+  /** @brief Number of columns per row (as required, else the first row's; 0 before any row). */
+  std::size_t num_columns() const { return _num_columns; }
+
+private:
+  void parse_line(char const *first, char const *last, std::vector<T> &out) {
+    if (first != last && *(last - 1) == '\r') {
+      --last;
+    }
+    if (first == last) {
+      return;
+    }
+    ++_num_rows;
+    std::size_t column = 0;
+    char const *pos = first;
+    while (true) {
+      // Stream extraction skipped leading blanks; keep accepting "1, 2".
+      while (pos != last && (*pos == ' ' || *pos == '\t') && *pos != _delimiter) {
+        ++pos;
+      }
+      T value{};
+      char const *end = parse_number(pos, last, value);
+      if (end == pos || (end != last && *end != _delimiter)) {
+        auto const *delimiter = static_cast<char const *>(
+            std::memchr(pos, _delimiter, static_cast<std::size_t>(last - pos)));
+        char const *token_end = delimiter != nullptr ? delimiter : last;
+        std::string_view token(pos, static_cast<std::size_t>(token_end - pos));
+        if (end != pos) {
+          throw std::runtime_error("unexpected character after value at row " +
+                                   std::to_string(_row_offset + _num_rows));
+        }
+        if (!_allow_missing || !is_missing_token(token)) {
+          throw std::runtime_error("invalid value '" + std::string(token) + "' at row " +
+                                   std::to_string(_row_offset + _num_rows));
+        }
+        value = std::numeric_limits<T>::quiet_NaN();
+        end = token_end;
+      }
+      out.push_back(value);
+      ++column;
+      if (end == last) {
+        break;
+      }
+      pos = end + 1;
+    }
+    if (_num_columns == 0) {
+      _num_columns = column;
+    } else if (column != _num_columns) {
+      throw std::runtime_error("inconsistent number of columns at matrix row " +
+                               std::to_string(_row_offset + _num_rows));
+    }
+  }
+
+  char _delimiter;
+  bool _allow_missing;
+  std::size_t _num_columns;
+  std::size_t _row_offset;
+  std::size_t _num_rows = 0;
+};
+
+/**
+ * @brief Read the rest of @p is in parse_block_size blocks and parse it.
+ *
+ * Each block is cut after its last newline; the partial line is carried into
+ * the next block, which grows only if a single line exceeds it. After every
+ * block, @p on_block is called with @p out holding the values of all complete
+ * rows parsed so far that it has not consumed; it may clear @p out to keep
+ * memory bounded by one block.
+ */
+template <typename T, typename OnBlock>
+void read_delimited(std::istream &is, delimited_parser<T> &parser, std::vector<T> &out,
+                    OnBlock &&on_block) {
+  std::vector<char> block(parse_block_size);
+  std::size_t carry = 0;
+  while (true) {
+    if (carry == block.size()) {
+      block.resize(block.size() * 2);
+    }
+    is.read(block.data() + carry, static_cast<std::streamsize>(block.size() - carry));
+    auto got = static_cast<std::size_t>(is.gcount());
+    std::size_t filled = carry + got;
+    if (got == 0) {
+      parser.parse(block.data(), block.data() + filled, out);
+      on_block(out);
+      return;
+    }
+    std::size_t newline = std::string_view(block.data(), filled).rfind('\n');
+    if (newline == std::string_view::npos) {
+      carry = filled;
+      continue;
+    }
+    parser.parse(block.data(), block.data() + newline + 1, out);
+    on_block(out);
+    carry = filled - (newline + 1);
+    std::memmove(block.data(), block.data() + newline + 1, carry);
+  }
+}
+
+/** @brief Read and parse the rest of @p is, appending every value to @p out. */
+template <typename T>
+void read_delimited(std::istream &is, delimited_parser<T> &parser, std::vector<T> &out) {
+  read_delimited(is, parser, out, [](std::vector<T> &) {});
+}
+
+} // namespace detail
+
+#endif
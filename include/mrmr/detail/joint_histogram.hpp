@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_DETAIL_JOINT_HISTOGRAM_HPP
+#define MRMR_DETAIL_JOINT_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+// Trait to detect data sources that expose each attribute as one contiguous
+// column via column_data(attr). compute_mi uses it to hand the raw columns to
+// the specialized joint-histogram kernels below instead of going through
+// operator() per instance.
+template <typename D, typename = void> struct has_column_data : std::false_type {};
+template <typename D>
+struct has_column_data<
+    D, std::void_t<decltype(std::declval<D const &>().column_data(std::size_t{}))>>
+    : std::true_type {};
+
+// Trait to detect data sources that read attribute a of instance i as
+// source_column(a)[instance_index_data()[i]] (e.g., dataset_view's instance
+// indirection). compute_mi and compute_mi_tile then resolve the column and
+// index pointers once per pair or block instead of once per instance.
+template <typename D, typename = void> struct has_indexed_columns : std::false_type {};
+template <typename D>
+struct has_indexed_columns<
+    D, std::void_t<decltype(std::declval<D const &>().source_column(std::size_t{})),
+                   decltype(std::declval<D const &>().instance_index_data())>>
+    : std::true_type {};
+
+/// Instances processed per inner block. Small enough that the per-block
+/// counters and code buffer stay in L1, large enough to amortize the flush.
+inline constexpr std::size_t joint_histogram_block = 4096;
+
+/// Largest joint cell count handled by the compare-and-count kernel. Its cost
+/// grows with one pass per cell; past about a dozen cells the interleaved
+/// kernel is faster.
+inline constexpr std::size_t compare_count_max_cells = 12;
+
+/// Largest joint cell count handled by the interleaved sub-histogram kernel.
+inline constexpr std::size_t interleaved_max_cells = 256;
+
+/// Joint alphabets up to this many cells are always counted densely: the
+/// specialized kernels above beat any sparse bookkeeping.
+inline constexpr std::size_t sparse_joint_min_cells = interleaved_max_cells;
+
+/// Largest joint alphabet counted sparsely in a direct-addressed table (see
+/// mi_from_sparse_joint); larger ones sort the instances' joint codes instead.
+/// Bounds the per-thread table at 8 MiB of 64-bit counters.
+inline constexpr std::size_t sparse_direct_max_cells = std::size_t{1} << 20;
+
+/**
+ * @brief Whether the k1 x k2 joint histogram of @p n instances should be
+ *        counted sparsely (see mi_from_sparse_joint) rather than densely.
+ *
+ * Sparse once the alphabet has more cells than there are instances: at most
+ * @p n cells can then be non-empty, so zeroing and scanning the dense
+ * histogram costs more than tracking the cells actually written.
+ */
+inline bool use_sparse_joint(std::size_t k1, std::size_t k2, std::size_t n) {
+  std::size_t cells = k1 * k2;
+  return cells > sparse_joint_min_cells && cells > n;
+}
+
+/**
+ * @brief Call @p f with a value of the narrowest unsigned counter type that can
+ *        hold a count of @p n.
+ *
+ * A joint histogram of n instances never has a bin above n, so counting into
+ * std::uint16_t (n <= 65535) or std::uint32_t bins instead of std::size_t
+ * shrinks the histogram four- or two-fold and keeps wider alphabets in L1/L2
+ * for the scattered increments. The counts themselves are unchanged.
+ */
+template <typename F> decltype(auto) with_joint_counter(std::size_t n, F &&f) {
+  if (n <= std::numeric_limits<std::uint16_t>::max()) {
+    return f(std::uint16_t{});
+  }
+  if (n <= std::numeric_limits<std::uint32_t>::max()) {
+    return f(std::uint32_t{});
+  }
+  return f(std::size_t{});
+}
+
+/**
+ * @brief Joint counts of two binary columns in a single fused pass.
+ *
+ * Computes n11 = sum(a & b), n1 = sum(a), and n2 = sum(b) with branch-free
+ * reductions that the compiler vectorizes, then derives all four cells.
+ * Values must be in {0, 1}. Counts are added to @p hist (layout v1 * 2 + v2).
+ */
+template <typename T, typename Count>
+void count_joint_binary(T const *col1, T const *col2, std::size_t n, Count *hist) {
+  std::size_t n11 = 0;
+  std::size_t n1 = 0;
+  std::size_t n2 = 0;
+  for (std::size_t begin = 0; begin < n; begin += joint_histogram_block) {
+    std::size_t end = std::min(begin + joint_histogram_block, n);
+    // 32-bit block accumulators keep the reduction lanes narrow; one block
+    // cannot overflow them.
+    std::uint32_t block11 = 0;
+    std::uint32_t block1 = 0;
+    std::uint32_t block2 = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      std::uint32_t a = col1[i];
+      std::uint32_t b = col2[i];
+      block11 += a & b;
+      block1 += a;
+      block2 += b;
+    }
+    n11 += block11;
+    n1 += block1;
+    n2 += block2;
+  }
+  hist[0] = static_cast<Count>(hist[0] + (n - n1 - n2 + n11));
+  hist[1] = static_cast<Count>(hist[1] + (n2 - n11));
+  hist[2] = static_cast<Count>(hist[2] + (n1 - n11));
+  hist[3] = static_cast<Count>(hist[3] + n11);
+}
+
+/**
+ * @brief Joint counts for small joint alphabets by compare-and-count.
+ *
+ * Each block of instances is first encoded as 8-bit joint codes
+ * (v1 * k2 + v2); every cell is then counted with a separate equality-sum pass
+ * over the block. Each pass is a data-independent reduction that vectorizes,
+ * which beats scattered increments while k1 * k2 stays small (the increments
+ * serialize on store-to-load forwarding whenever consecutive instances hit the
+ * same bin, which is the common case for low-cardinality data).
+ *
+ * Requires k1 * k2 <= compare_count_max_cells. Counts are added to @p hist.
+ */
+template <typename T, typename Count>
+void count_joint_compare(T const *col1, T const *col2, std::size_t n, std::size_t k2,
+                         std::size_t cells, Count *hist) {
+  std::array<std::uint8_t, joint_histogram_block> codes;
+  auto stride = static_cast<std::uint8_t>(k2);
+  for (std::size_t begin = 0; begin < n; begin += joint_histogram_block) {
+    std::size_t len = std::min(joint_histogram_block, n - begin);
+    T const *block1 = col1 + begin;
+    T const *block2 = col2 + begin;
+    for (std::size_t i = 0; i < len; ++i) {
+      codes[i] = static_cast<std::uint8_t>(block1[i] * stride + block2[i]);
+    }
+    for (std::size_t cell = 0; cell < cells; ++cell) {
+      auto code = static_cast<std::uint8_t>(cell);
+      std::size_t count = 0;
+      // 8-bit partial sums keep all vector lanes busy; 255 compares cannot
+      // overflow them.
+      for (std::size_t sub = 0; sub < len; sub += 255) {
+        std::size_t sub_end = std::min(sub + 255, len);
+        std::uint8_t partial = 0;
+        for (std::size_t i = sub; i < sub_end; ++i) {
+          partial = static_cast<std::uint8_t>(partial + (codes[i] == code));
+        }
+        count += partial;
+      }
+      hist[cell] = static_cast<Count>(hist[cell] + count);
+    }
+  }
+}
+
+/**
+ * @brief Joint counts for moderate joint alphabets with interleaved sub-histograms.
+ *
+ * Consecutive instances increment four independent 32-bit sub-histograms in
+ * rotation, so runs of equal joint codes no longer form a single
+ * read-modify-write dependency chain. The sub-histograms are reduced into
+ * @p hist at the end of every chunk small enough that no 32-bit bin can wrap.
+ *
+ * Requires k1 * k2 <= interleaved_max_cells. Counts are added to @p hist.
+ */
+template <typename T, typename Count>
+void count_joint_interleaved(T const *col1, T const *col2, std::size_t n, std::size_t k2,
+                             std::size_t cells, Count *hist) {
+  constexpr std::size_t lanes = 4;
+  // Each lane sees at most chunk / lanes increments per chunk.
+  constexpr std::size_t chunk = std::size_t{1} << 31;
+  std::array<std::array<std::uint32_t, interleaved_max_cells>, lanes> sub;
+  for (std::size_t begin = 0; begin < n; begin += chunk) {
+    std::size_t end = begin + std::min(chunk, n - begin);
+    for (auto &lane : sub) {
+      std::fill(lane.begin(), lane.begin() + static_cast<std::ptrdiff_t>(cells), 0u);
+    }
+    std::size_t i = begin;
+    for (; i + lanes <= end; i += lanes) {
+      ++sub[0][col1[i] * k2 + col2[i]];
+      ++sub[1][col1[i + 1] * k2 + col2[i + 1]];
+      ++sub[2][col1[i + 2] * k2 + col2[i + 2]];
+      ++sub[3][col1[i + 3] * k2 + col2[i + 3]];
+    }
+    for (; i < end; ++i) {
+      ++sub[0][col1[i] * k2 + col2[i]];
+    }
+    for (std::size_t cell = 0; cell < cells; ++cell) {
+      hist[cell] = static_cast<Count>(hist[cell] + std::size_t{sub[0][cell]} + sub[1][cell] +
+                                      sub[2][cell] + sub[3][cell]);
+    }
+  }
+}
+
+/**
+ * @brief Accumulate the joint histogram of two contiguous columns.
+ *
+ * Dispatches on the attribute cardinalities: a fused reduction for
+ * binary x binary, compare-and-count for joint alphabets of at most
+ * compare_count_max_cells, interleaved sub-histograms up to
+ * interleaved_max_cells, and the plain scattered-increment loop above that.
+ * Every kernel produces exactly the same integer counts, so MI values computed
+ * from the histogram are bit-identical regardless of which kernel ran.
+ *
+ * @param col1 First column; values in [0, k1).
+ * @param col2 Second column; values in [0, k2).
+ * @param n    Number of instances.
+ * @param k1   Number of distinct values of the first column.
+ * @param k2   Number of distinct values of the second column.
+ * @param hist Histogram of k1 * k2 bins (layout v1 * k2 + v2); counts are added.
+ *             Count may be narrower than std::size_t (see with_joint_counter)
+ *             as long as no bin exceeds its range.
+ */
+template <typename T, typename Count>
+void count_joint(T const *col1, T const *col2, std::size_t n, std::size_t k1, std::size_t k2,
+                 Count *hist) {
+  std::size_t cells = k1 * k2;
+  if (k1 == 2 && k2 == 2) {
+    count_joint_binary(col1, col2, n, hist);
+  } else if (cells <= compare_count_max_cells) {
+    count_joint_compare(col1, col2, n, k2, cells, hist);
+  } else if (cells <= interleaved_max_cells) {
+    count_joint_interleaved(col1, col2, n, k2, cells, hist);
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      ++hist[col1[i] * k2 + col2[i]];
+    }
+  }
+}
+
+} // namespace detail
+
+#endif
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_DETAIL_MAPPED_FILE_HPP
+#define MRMR_DETAIL_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace detail {
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Maps the file with mmap(PROT_READ, MAP_PRIVATE) and unmaps it on
+ * destruction. The file descriptor is closed as soon as the mapping exists;
+ * the mapping keeps the pages reachable. Pages are faulted in on first touch,
+ * so mapping a multi-gigabyte file is O(1) until its contents are read.
+ * Non-copyable and non-movable; share it through a std::shared_ptr.
+ */
+class mapped_file {
+public:
+  /**
+   * @brief Map @p path into memory.
+   *
+   * @param path File to map.
+   * @throws std::runtime_error If the file cannot be opened, inspected, or mapped.
+   */
+  explicit mapped_file(std::string const &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::runtime_error(path + ": " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::runtime_error(path + ": " + std::strerror(err));
+    }
+    _size = static_cast<std::size_t>(st.st_size);
+    if (_size > 0) {
+      void *addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error(path + ": " + std::strerror(err));
+      }
+      _addr = addr;
+    }
+    ::close(fd);
+  }
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+
+  ~mapped_file() {
+    if (_addr != nullptr) {
+      ::munmap(_addr, _size);
+    }
+  }
+
+  /** @brief First byte of the mapping (nullptr for an empty file). */
+  std::byte const *data() const { return static_cast<std::byte const *>(_addr); }
+
+  /** @brief Size of the mapped file in bytes. */
+  std::size_t size() const { return _size; }
+
+private:
+  void *_addr = nullptr;
+  std::size_t _size = 0;
+};
+
+} // namespace detail
+
+#endif
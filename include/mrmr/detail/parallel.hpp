@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_DETAIL_PARALLEL_HPP
+#define MRMR_DETAIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace detail {
+
+/**
+ * @brief Resolve a user-facing thread count to the number of threads to run.
+ *
+ * A request of 0 means "all cores" and resolves to
+ * std::thread::hardware_concurrency(), or 1 when the platform cannot report it.
+ *
+ * @param requested Requested thread count (0 = hardware concurrency).
+ * @return Thread count >= 1.
+ */
+inline std::size_t resolve_thread_count(std::size_t requested) {
+  if (requested != 0) {
+    return requested;
+  }
+  unsigned hardware = std::thread::hardware_concurrency();
+  return hardware == 0 ? 1 : static_cast<std::size_t>(hardware);
+}
+
+/**
+ * @brief Minimal fork-join thread pool for data-parallel loops.
+ *
+ * Holds num_threads - 1 persistent workers; the calling thread participates in
+ * every parallel_for, so a pool of size 1 spawns nothing and runs inline. Work
+ * is distributed dynamically in fixed-size chunks from a shared atomic counter,
+ * which load-balances loops whose iterations have uneven cost (e.g., the rows
+ * of a triangular matrix).
+ *
+ * The pool is intended to live for the duration of one algorithm call, so the
+ * thread start-up cost is paid once rather than once per loop. parallel_for is
+ * not reentrant: the body must not call parallel_for on the same pool.
+ */
+class thread_pool {
+public:
+  /**
+   * @brief Start the pool.
+   *
+   * @param num_threads Total participants including the caller (0 = hardware concurrency).
+   */
+  explicit thread_pool(std::size_t num_threads);
+
+  ~thread_pool();
+
+  thread_pool(thread_pool const &) = delete;
+  thread_pool &operator=(thread_pool const &) = delete;
+
+  /** @brief Return the number of participating threads, including the caller. */
+  std::size_t size() const { return _workers.size() + 1; }
+
+  /**
+   * @brief Run @p body over [0, count) in chunks of at most @p grain iterations.
+   *
+   * @p body is invoked as body(begin, end) for disjoint half-open ranges that
+   * together cover [0, count). Ranges are claimed in increasing order, but may
+   * complete in any order. Runs inline when the pool has one thread or the loop
+   * fits in a single chunk. The first exception thrown by any invocation of
+   * @p body is rethrown on the calling thread after all participants finish.
+   *
+   * @param count Number of iterations.
+   * @param grain Maximum iterations per chunk (values of 0 are treated as 1).
+   * @param body  Callable with signature void(std::size_t begin, std::size_t end).
+   */
+  template <typename Body> void parallel_for(std::size_t count, std::size_t grain, Body &&body);
+
+private:
+  void worker_main();
+  void shutdown();
+  void run(std::function<void()> const &task);
+
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _work_cv;
+  std::condition_variable _done_cv;
+  std::function<void()> const *_task = nullptr;
+  std::size_t _generation = 0;
+  std::size_t _pending = 0;
+  bool _stop = false;
+};
+
+inline thread_pool::thread_pool(std::size_t num_threads) {
+  std::size_t total = resolve_thread_count(num_threads);
+  _workers.reserve(total - 1);
+  try {
+    for (std::size_t i = 1; i < total; ++i) {
+      _workers.emplace_back([this] { worker_main(); });
+    }
+  } catch (...) {
+    // Thread creation failed part-way; join what was started before propagating.
+    shutdown();
+    throw;
+  }
+}
+
+inline thread_pool::~thread_pool() { shutdown(); }
+
+inline void thread_pool::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _work_cv.notify_all();
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+
+inline void thread_pool::worker_main() {
+  std::size_t seen_generation = 0;
+  for (;;) {
+    std::function<void()> const *task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_cv.wait(lock, [&] { return _stop || _generation != seen_generation; });
+      if (_stop) {
+        return;
+      }
+      seen_generation = _generation;
+      task = _task;
+    }
+    (*task)();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (--_pending == 0) {
+        _done_cv.notify_one();
+      }
+    }
+  }
+}
+
+inline void thread_pool::run(std::function<void()> const &task) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _task = &task;
+    _pending = _workers.size();
+    ++_generation;
+  }
+  _work_cv.notify_all();
+  task();
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done_cv.wait(lock, [this] { return _pending == 0; });
+  _task = nullptr;
+}
+
+template <typename Body>
+void thread_pool::parallel_for(std::size_t count, std::size_t grain, Body &&body) {
+  grain = std::max<std::size_t>(grain, 1);
+  if (_workers.empty() || count <= grain) {
+    if (count > 0) {
+      body(std::size_t{0}, count);
+    }
+    return;
+  }
+
+  // Chunks are claimed from a shared counter; the task itself never throws so
+  // that workers stay alive. The first failure stops further chunk claims and
+  // is rethrown on the caller once every participant has drained.
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr failure;
+  std::mutex failure_mutex;
+  std::function<void()> task = [&] {
+    for (;;) {
+      std::size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+      if (begin >= count) {
+        return;
+      }
+      std::size_t end = std::min(begin + grain, count);
+      try {
+        body(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(failure_mutex);
+        if (!failure) {
+          failure = std::current_exception();
+        }
+        next.store(count, std::memory_order_relaxed);
+        return;
+      }
+    }
+  };
+  run(task);
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+/**
+ * @brief Run a one-off parallel loop on a temporary pool of @p num_threads threads.
+ *
+ * Convenience wrapper for call sites that parallelize a single loop; see
+ * thread_pool::parallel_for for the semantics of @p grain and @p body.
+ */
+template <typename Body>
+void parallel_for(std::size_t num_threads, std::size_t count, std::size_t grain, Body &&body) {
+  thread_pool pool(std::min(resolve_thread_count(num_threads), std::max<std::size_t>(count, 1)));
+  pool.parallel_for(count, grain, std::forward<Body>(body));
+}
+
+} // namespace detail
+
+#endif
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_DETAIL_XLOGX_TABLE_HPP
+#define MRMR_DETAIL_XLOGX_TABLE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail {
+
+/**
+ * @brief Lazily built table of c * log2(c) for the counts c in [0, max_count].
+ *
+ * Lets integer joint histograms be turned into mutual information without a
+ * log2 call per cell (see mi_from_joint_cells). The table is filled on the
+ * first call to values(), under a std::once_flag, so concurrent MI calls on
+ * the same dataset may race to it safely; entry 0 is 0 by the usual
+ * 0 * log2(0) = 0 convention. Entries depend only on their count, so MI
+ * values computed from the table are reproducible from run to run.
+ * Non-copyable and non-movable; share it through a std::shared_ptr.
+ */
+class xlogx_table {
+public:
+  /** @param max_count Largest count the table must cover (typically N). */
+  explicit xlogx_table(std::size_t max_count) : _max_count(max_count) {}
+
+  xlogx_table(xlogx_table const &) = delete;
+  xlogx_table &operator=(xlogx_table const &) = delete;
+
+  /** @brief Largest count covered by the table. */
+  std::size_t max_count() const { return _max_count; }
+
+  /** @brief The max_count() + 1 entries of the table, building it on first use. */
+  double const *values() const {
+    std::call_once(_built, [this] {
+      _values.resize(_max_count + 1);
+      _values[0] = 0.0;
+      for (std::size_t c = 1; c <= _max_count; ++c) {
+        auto x = static_cast<double>(c);
+        _values[c] = x * std::log2(x);
+      }
+    });
+    return _values.data();
+  }
+
+private:
+  std::size_t _max_count;
+  mutable std::once_flag _built;
+  mutable std::vector<double> _values;
+};
+
+/// Largest instance count given a table. The table costs 8 bytes per count
+/// (32 MiB at this bound); past it, lookups miss cache about as often as a
+/// log2 call costs, so larger datasets keep the per-cell form instead.
+inline constexpr std::size_t xlogx_table_max_count = std::size_t{1} << 22;
+
+/// Largest difference, in bits, between mutual information evaluated through
+/// an xlogx_table and through per-cell log2 of probabilities, for the joint
+/// histograms compute_mi builds; both are sums of the same terms, regrouped.
+inline constexpr double mi_table_tolerance = 1e-12;
+
+/// Detects a data source exposing a count table through xlogx().
+template <typename D, typename = void> struct has_xlogx_table : std::false_type {};
+template <typename D>
+struct has_xlogx_table<D, std::void_t<decltype(std::declval<D const &>().xlogx())>>
+    : std::true_type {};
+
+/// The count table of @p data, or nullptr if it has none.
+template <typename DataSource> xlogx_table const *xlogx_of(DataSource const &data) {
+  if constexpr (has_xlogx_table<DataSource>::value) {
+    return data.xlogx();
+  } else {
+    return nullptr;
+  }
+}
+
+} // namespace detail
+
+#endif
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <iostream>
 #include <iterator>
+#include <mrmr/detail/delimited_parser.hpp>
 #include <stdexcept>
 #include <valarray>
 #include <vector>
@@ -15,7 +16,7 @@
 /**
  * @brief A dense, row-major two-dimensional matrix backed by std::valarray.
  *
- * Provides O(1) element access and an efficient slice-based transpose. The
+ * Provides O(1) element access and a cache-blocked transpose. The
  * delimiter character controls how rows and columns are separated when reading
  * from or writing to streams.
  *
@@ -100,7 +101,8 @@ public:
    *
    * Determines the number of rows and columns from the stream content. Each
    * row must contain the same number of delimiter-separated values; rows are
-   * terminated by newline characters.
+   * terminated by newline characters. The rest of the stream is read in large
+   * blocks and parsed with std::from_chars; blank lines are skipped.
    *
    * @param is Input stream to read from.
    * @throws std::runtime_error If any row has an inconsistent column count or
@@ -156,11 +158,22 @@ template <typename T> T &matrix<T>::operator()(std::size_t row, std::size_t colu
 }
 
 template <typename T> matrix<T> matrix<T>::transpose() const {
+  // Copy square tiles so that both the reads and the strided writes of a
+  // tile stay in cache; a whole-row slice assignment writes with stride
+  // num_rows() and touches a new cache line for every element.
+  constexpr std::size_t tile = 32;
   matrix<T> result(num_columns(), num_rows());
   result._delimiter = _delimiter;
-  for (std::size_t row = 0; row < num_rows(); ++row) {
-    result._data[std::slice(row, num_columns(), num_rows())] =
-        _data[std::slice(row * num_columns(), num_columns(), 1)];
+  for (std::size_t row_tile = 0; row_tile < num_rows(); row_tile += tile) {
+    std::size_t row_end = std::min(row_tile + tile, num_rows());
+    for (std::size_t column_tile = 0; column_tile < num_columns(); column_tile += tile) {
+      std::size_t column_end = std::min(column_tile + tile, num_columns());
+      for (std::size_t row = row_tile; row < row_end; ++row) {
+        for (std::size_t column = column_tile; column < column_end; ++column) {
+          result._data[column * num_rows() + row] = _data[row * num_columns() + column];
+        }
+      }
+    }
   }
   return result;
 }
@@ -212,84 +225,17 @@ template <typename T> void matrix<T>::write_to(std::ostream &os) const {
 }
 
 template <typename T> void matrix<T>::read_from(std::istream &is) {
-  // Parse delimited matrix from stream. Dimensions are determined from the data.
-  // Uses vector for efficient dynamic growth, converts to valarray at end.
+  // Parse delimited matrix from stream in large blocks (see detail::delimited_parser).
+  // Dimensions are determined from the data. When _allow_missing is true,
+  // recognized missing value tokens (NA, NaN, nan, ?, empty field) are replaced
+  // with NaN instead of causing a parse error. Unrecognized tokens still throw.
+  detail::delimited_parser<T> parser(_delimiter, _allow_missing);
   std::vector<T> buffer;
-  buffer.reserve(256);
-  _num_rows = 0;
-  _num_columns = 0;
-  std::size_t column_num = 0;
-
-  // Read values until EOF. When _allow_missing is true, recognized missing
-  // value tokens (NA, NaN, ?, empty field) are replaced with NaN instead of
-  // causing a parse error. Unrecognized tokens still throw.
-  T d;
-  auto try_read_value = [&](T &val) -> bool {
-    if (is >> val) {
-      return true;
-    }
-    if (is.eof()) {
-      return false;
-    }
-    // Extraction failed — check if it's a recognized missing value token
-    if (_allow_missing && std::is_floating_point<T>::value) {
-      is.clear(); // reset failbit
-      std::string token;
-      // Read until delimiter or newline
-      char ch;
-      while (is.get(ch)) {
-        if (ch == _delimiter || ch == '\n') {
-          is.putback(ch);
-          break;
-        }
-        token += ch;
-      }
-      if (token == "NA" || token == "NaN" || token == "nan" || token == "?" || token.empty()) {
-        val = std::numeric_limits<T>::quiet_NaN();
-        return true;
-      }
-      throw std::runtime_error("invalid value '" + token + "' at row " +
-                               std::to_string(_num_rows + 1));
-    }
-    return false;
-  };
-
-  while (try_read_value(d)) {
-    if (column_num == 0) {
-      ++_num_rows;
-    }
-    if (_num_rows == 1) {
-      _num_columns = column_num + 1;
-    }
-    buffer.push_back(d);
-
-    // Read the separator character following the value
-    auto c = static_cast<char>(is.get());
-    if (c == _delimiter) {
-      ++column_num;
-    } else if (c == '\n') {
-      if (column_num + 1 != _num_columns) {
-        throw std::runtime_error("inconsistent number of columns at matrix row " +
-                                 std::to_string(_num_rows));
-      }
-      column_num = 0;
-    } else if (is.eof()) {
-      // Value was the last in the stream with no trailing separator
-      if (_num_columns > 0 && column_num + 1 != _num_columns) {
-        throw std::runtime_error("inconsistent number of columns at matrix row " +
-                                 std::to_string(_num_rows));
-      }
-      break;
-    } else {
-      throw std::runtime_error("unexpected character after value at row " +
-                               std::to_string(_num_rows));
-    }
-
-    // Peek to detect EOF before the next extraction attempt
-    is.peek();
-  }
+  detail::read_delimited(is, parser, buffer);
+  _num_rows = parser.num_rows();
+  _num_columns = parser.num_columns();
 
-  // Convert buffer to valarray for slice-based operations (transpose)
+  // Copy buffer into the valarray storage
   _data.resize(buffer.size());
   std::copy(buffer.begin(), buffer.end(), std::begin(_data));
 }
@@ -4,10 +4,20 @@
 #ifndef MRMR_MI_POLICY_HPP
 #define MRMR_MI_POLICY_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <mrmr/attribute_information.hpp>
+#include <mrmr/detail/joint_histogram.hpp>
+#include <mrmr/detail/xlogx_table.hpp>
 #include <mrmr/missing.hpp>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 /**
@@ -70,11 +80,51 @@ struct weighted_policy {
   double normalize(histogram_type count, double /*inv_n*/) const { return count / total_weight; }
 };
 
+/**
+ * @brief MI accumulation policy for instances with integer multiplicities.
+ *
+ * Each instance adds its multiplicity (e.g., how often a bootstrap sample drew
+ * it) to an integer histogram, so the joint counts, and therefore the MI, are
+ * exactly those of a source that lists every instance that many times.
+ * Instances with multiplicity zero are accumulated too (adding nothing), which
+ * keeps the counting loop free of branches.
+ *
+ * @tparam Count Unsigned integer type of the multiplicities.
+ */
+template <typename Count> struct multiplicity_policy {
+  using histogram_type = std::size_t;
+
+  /// Signals to mi_from_sparse_joint that an instance adds its multiplicity
+  /// rather than one to its cell.
+  static constexpr bool accumulates_multiplicity = true;
+
+  Count const *counts;
+
+  /**
+   * @brief Construct from a multiplicity array.
+   *
+   * @param c Pointer to one multiplicity per instance (must outlive this policy).
+   */
+  explicit multiplicity_policy(Count const *c) : counts(c) {}
+
+  /** @brief All instances are included (multiplicities handle contribution). */
+  bool include(std::size_t /*inst*/) const { return true; }
+
+  /** @brief Add the instance's multiplicity to the histogram bin. */
+  void accumulate(histogram_type &cell, std::size_t inst) const { cell += counts[inst]; }
+
+  /** @brief Convert histogram count to probability via reciprocal multiply. */
+  double normalize(histogram_type count, double inv_n) const {
+    return static_cast<double>(count) * inv_n;
+  }
+};
+
 /**
  * @brief MI accumulation policy for pairwise-complete observations.
  *
- * Skips instances where either attribute has a missing value (sentinel value 255
- * for unsigned char). Uses integer histogram like unweighted_policy.
+ * Skips instances where either attribute has a missing value (the sentinel
+ * missing_sentinel<T>::value, e.g. 255 for unsigned char). Uses integer
+ * histogram like unweighted_policy.
  *
  * This implements the "pairwise deletion" approach used in mRMRe: for each MI(X,Y)
  * computation, only instances where both X and Y are observed contribute.
@@ -127,12 +177,322 @@ template <typename P> constexpr bool derives_marginals_from_joint_v() {
   return detail::has_derives_marginals<P>::value;
 }
 
+// Trait to detect whether a policy has accumulates_multiplicity = true, i.e.
+// an instance may add more (or less) than one to an integer histogram cell.
+namespace detail {
+template <typename P, typename = void> struct has_accumulates_multiplicity : std::false_type {};
+template <typename P>
+struct has_accumulates_multiplicity<P, typename std::enable_if<P::accumulates_multiplicity>::type>
+    : std::true_type {};
+} // namespace detail
+
+template <typename P> constexpr bool accumulates_multiplicity_v() {
+  return detail::has_accumulates_multiplicity<P>::value;
+}
+
+namespace detail {
+
+/**
+ * @brief Evaluate mutual information from integer joint counts and a table of
+ *        c * log2(c) (see mi_from_joint_cells).
+ *
+ * The table must cover the histogram total. Sums run in cell order, then
+ * row order, then column order, so the result depends only on the counts.
+ */
+template <typename ForEachCell>
+double mi_from_joint_counts(ForEachCell &&for_each_cell, std::size_t k1, std::size_t k2,
+                            double const *xlogx) {
+  // Leaked thread-local scratch, as in compute_mi.
+  static thread_local auto *margins_ptr = new std::vector<std::size_t>();
+  auto &margins = *margins_ptr;
+  margins.assign(k1 + k2, 0);
+  std::size_t total = 0;
+  double joint = 0.0;
+  for_each_cell([&](std::size_t i, std::size_t j, auto count) {
+    auto c = static_cast<std::size_t>(count);
+    margins[i] += c;
+    margins[k1 + j] += c;
+    total += c;
+    joint += xlogx[c];
+  });
+  if (total == 0) {
+    return 0.0;
+  }
+  double marginal = 0.0;
+  for (std::size_t margin : margins) {
+    marginal += xlogx[margin];
+  }
+  return (joint - marginal + xlogx[total]) / static_cast<double>(total);
+}
+
+/**
+ * @brief Turn joint counts into mutual information.
+ *
+ * @p for_each_cell(f) must call f(i, j, count) for the cells (i, j) of a
+ * k1 x k2 joint histogram in increasing order of i * k2 + j; it may skip empty
+ * cells. Empty cells add nothing to any sum, so a dense histogram and the
+ * sparse list of its non-empty cells yield bit-identical values.
+ *
+ * Given a count table (integer histograms only), MI is evaluated from counts
+ * as (sum c_ij log2 c_ij - sum a_i log2 a_i - sum b_j log2 b_j + n log2 n) / n,
+ * with the row sums a_i, column sums b_j, and total n taken from the joint
+ * counts, so the only log2 evaluations are table lookups. The row and column
+ * sums equal the attribute_information marginals whenever the policy counts
+ * every instance, so this is the same quantity as the probability form below.
+ * The result is deterministic but not bit-identical to it: the two differ by
+ * rounding only, within mi_table_tolerance.
+ *
+ * @param info1 Attribute information supplying marginals for the first attribute.
+ * @param info2 Attribute information supplying marginals for the second attribute.
+ * @param table c * log2(c) for counts up to the histogram total, or nullptr to
+ *              evaluate the probability form with std::log2 per cell.
+ * @return Mutual information in bits, or 0 if the histogram is empty.
+ */
+template <typename T, typename Policy, typename ForEachCell>
+double mi_from_joint_cells(ForEachCell &&for_each_cell, std::size_t k1, std::size_t k2,
+                           attribute_information<T> const &info1,
+                           attribute_information<T> const &info2, Policy const &policy,
+                           xlogx_table const *table = nullptr) {
+  if constexpr (std::is_integral_v<typename Policy::histogram_type>) {
+    if (table != nullptr) {
+      return mi_from_joint_counts(for_each_cell, k1, k2, table->values());
+    }
+  }
+
+  // Compute effective sample size from histogram (sum of all bins).
+  // For unweighted/weighted policies this equals N or total_weight.
+  // For pairwise-complete this equals the count of complete pairs.
+  double effective_total = 0;
+  for_each_cell([&](std::size_t, std::size_t, auto count) {
+    effective_total += static_cast<double>(count);
+  });
+  if (effective_total == 0) {
+    return 0.0;
+  }
+  double inv_n = 1.0 / effective_total;
+
+  double mi = 0.0;
+
+  // Derive marginals from the joint histogram when the policy requires it
+  // (e.g., pairwise-complete observations use different subsets per pair).
+  // For unweighted/weighted policies, use the precomputed attribute_information
+  // marginals which are faster (no extra computation).
+  // The trait check is compile-time; the compiler eliminates the unused branch.
+  if constexpr (derives_marginals_from_joint_v<Policy>()) {
+    std::vector<double> m1(k1, 0.0);
+    std::vector<double> m2(k2, 0.0);
+    for_each_cell([&](std::size_t i, std::size_t j, auto count) {
+      auto val = static_cast<double>(count);
+      m1[i] += val;
+      m2[j] += val;
+    });
+    for (auto &v : m1) {
+      v *= inv_n;
+    }
+    for (auto &v : m2) {
+      v *= inv_n;
+    }
+    for_each_cell([&](std::size_t i, std::size_t j, auto count) {
+      double joint_prob = policy.normalize(count, inv_n);
+      if (joint_prob > 0) {
+        mi += joint_prob * std::log2(joint_prob / (m1[i] * m2[j]));
+      }
+    });
+  } else {
+    for_each_cell([&](std::size_t i, std::size_t j, auto count) {
+      double joint_prob = policy.normalize(count, inv_n);
+      if (joint_prob > 0) {
+        // i and j are bounded by k1/k2, themselves bounded by the storage
+        // type T's domain, so the narrowing cast to T is value-preserving.
+        double marginal_i = info1.marginal_probability(static_cast<T>(i));
+        double marginal_j = info2.marginal_probability(static_cast<T>(j));
+        mi += joint_prob * std::log2(joint_prob / (marginal_i * marginal_j));
+      }
+    });
+  }
+
+  return mi;
+}
+
+/**
+ * @brief Turn a filled joint histogram into mutual information.
+ *
+ * Shared by compute_mi and compute_mi_batch so that both produce bit-identical
+ * values for the same histogram.
+ *
+ * @param hist  Joint histogram of k1 * k2 bins (layout v1 * k2 + v2), of the
+ *              policy's histogram type or, for integer counts, a narrower
+ *              unsigned type (see with_joint_counter).
+ * @param info1 Attribute information supplying marginals for the first attribute.
+ * @param info2 Attribute information supplying marginals for the second attribute.
+ * @return Mutual information in bits, or 0 if the histogram is empty.
+ */
+template <typename T, typename Policy, typename Count>
+double mi_from_joint_histogram(Count const *hist, std::size_t k1, std::size_t k2,
+                               attribute_information<T> const &info1,
+                               attribute_information<T> const &info2, Policy const &policy,
+                               xlogx_table const *table = nullptr) {
+  auto for_each_cell = [hist, k1, k2](auto &&f) {
+    for (std::size_t i = 0; i < k1; ++i) {
+      for (std::size_t j = 0; j < k2; ++j) {
+        f(i, j, hist[i * k2 + j]);
+      }
+    }
+  };
+  return mi_from_joint_cells(for_each_cell, k1, k2, info1, info2, policy, table);
+}
+
+/**
+ * @brief Compute mutual information touching only the non-empty joint cells.
+ *
+ * @p code_of(i) must return the joint code v1 * k2 + v2 of instance i. Two
+ * counting schemes share this entry point:
+ *
+ * - Up to sparse_direct_max_cells cells, instances are accumulated into a
+ *   direct-addressed table that is kept zeroed between calls, and every write
+ *   sets the cell's bit in an occupancy bitmap. The MI sum and the reset visit
+ *   only the set bits, in code order; the bitmap scan costs one word per 64
+ *   cells, so nothing else proportional to k1 * k2 is zeroed or read.
+ * - Past that, the codes of the included instances are sorted and each run
+ *   of equal codes is one cell. With an integer histogram type every included
+ *   instance counts once (as in unweighted_policy and
+ *   pairwise_complete_policy); otherwise, and for multiplicity_policy, the
+ *   instances of a cell are accumulated through the policy in instance order.
+ *
+ * Either way each cell accumulates in instance order and cells are visited in
+ * increasing code order, so the result is bit-identical to the dense histogram
+ * path given the same count table.
+ */
+template <typename T, typename Policy, typename JointCode>
+double mi_from_sparse_joint(JointCode &&code_of, std::size_t n, std::size_t k1, std::size_t k2,
+                            attribute_information<T> const &info1,
+                            attribute_information<T> const &info2, Policy const &policy,
+                            xlogx_table const *xlogx = nullptr) {
+  using histogram_type = typename Policy::histogram_type;
+  std::size_t num_cells = k1 * k2;
+
+  if (num_cells <= sparse_direct_max_cells) {
+    // Leaked thread-local scratch, as in compute_mi. The table is all zero
+    // except at the cells marked in the first dirty_words words of the
+    // occupancy bitmap, which are reset on entry; a call that exits early
+    // therefore never leaves stale counts behind.
+    static thread_local auto *table_ptr = new std::vector<histogram_type>();
+    static thread_local auto *occupied_ptr = new std::vector<std::uint64_t>();
+    static thread_local std::size_t dirty_words = 0;
+    auto &table = *table_ptr;
+    auto &occupied = *occupied_ptr;
+    auto for_each_occupied = [&occupied](std::size_t num_words, auto &&f) {
+      for (std::size_t w = 0; w < num_words; ++w) {
+        for (std::uint64_t bits = occupied[w]; bits != 0; bits &= bits - 1) {
+          f(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+        }
+      }
+    };
+    for_each_occupied(dirty_words, [&table](std::size_t code) { table[code] = histogram_type{}; });
+    std::fill_n(occupied.begin(), dirty_words, std::uint64_t{0});
+    std::size_t num_words = (num_cells + 63) / 64;
+    if (table.size() < num_cells) {
+      table.resize(num_cells);
+      occupied.resize(num_words);
+    }
+    dirty_words = num_words;
+
+    for (std::size_t i = 0; i < n; ++i) {
+      if (policy.include(i)) {
+        std::size_t code = code_of(i);
+        occupied[code / 64] |= std::uint64_t{1} << (code % 64);
+        policy.accumulate(table[code], i);
+      }
+    }
+
+    auto for_each_cell = [&](auto &&f) {
+      for_each_occupied(num_words, [&](std::size_t code) { f(code / k2, code % k2, table[code]); });
+    };
+    return mi_from_joint_cells(for_each_cell, k1, k2, info1, info2, policy, xlogx);
+  }
+
+  constexpr bool counting =
+      std::is_integral_v<histogram_type> && !accumulates_multiplicity_v<Policy>();
+  using entry_type =
+      std::conditional_t<counting, std::uint64_t, std::pair<std::uint64_t, std::size_t>>;
+  static thread_local auto *entries_ptr = new std::vector<entry_type>();
+  static thread_local auto *cells_ptr = new std::vector<std::pair<std::uint64_t, histogram_type>>();
+  auto &entries = *entries_ptr;
+  auto &cells = *cells_ptr;
+  entries.clear();
+  cells.clear();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (policy.include(i)) {
+      auto code = static_cast<std::uint64_t>(code_of(i));
+      if constexpr (counting) {
+        entries.push_back(code);
+      } else {
+        entries.emplace_back(code, i);
+      }
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  for (std::size_t begin = 0; begin < entries.size();) {
+    std::size_t end = begin + 1;
+    histogram_type cell{};
+    if constexpr (counting) {
+      while (end < entries.size() && entries[end] == entries[begin]) {
+        ++end;
+      }
+      cell = static_cast<histogram_type>(end - begin);
+      cells.emplace_back(entries[begin], cell);
+    } else {
+      while (end < entries.size() && entries[end].first == entries[begin].first) {
+        ++end;
+      }
+      for (std::size_t e = begin; e < end; ++e) {
+        policy.accumulate(cell, entries[e].second);
+      }
+      cells.emplace_back(entries[begin].first, cell);
+    }
+    begin = end;
+  }
+
+  auto for_each_cell = [&cells, k2](auto &&f) {
+    for (auto const &[code, count] : cells) {
+      f(static_cast<std::size_t>(code / k2), static_cast<std::size_t>(code % k2), count);
+    }
+  };
+  return mi_from_joint_cells(for_each_cell, k1, k2, info1, info2, policy, xlogx);
+}
+
+/**
+ * @brief Compute mutual information between two attributes of a data source
+ *        with sparse joint counting (see mi_from_sparse_joint).
+ */
+template <typename DataSource, typename Policy>
+double compute_mi_sparse(DataSource const &data,
+                         attribute_information<typename DataSource::value_type> const &info1,
+                         attribute_information<typename DataSource::value_type> const &info2,
+                         std::size_t attr1, std::size_t attr2, Policy const &policy) {
+  std::size_t k1 = info1.num_values();
+  std::size_t k2 = info2.num_values();
+  auto code_of = [&data, attr1, attr2, k2](std::size_t i) {
+    return std::size_t{data(attr1, i)} * k2 + data(attr2, i);
+  };
+  return mi_from_sparse_joint(code_of, data.num_instances(), k1, k2, info1, info2, policy,
+                              xlogx_of(data));
+}
+
+} // namespace detail
+
 /**
  * @brief Compute mutual information between two attributes of a data source.
  *
  * Templated on the MI accumulation policy for zero-overhead dispatch between
  * unweighted (integer histogram) and weighted (float histogram) paths. The
  * compiler inlines the policy methods, producing specialized code for each.
+ * Joint alphabets with more cells than instances (detail::use_sparse_joint)
+ * are counted sparsely instead of in a dense k1 * k2 histogram. Integer
+ * histograms of a data source with a count table (xlogx(), see
+ * detail::xlogx_table) are evaluated from counts through the table, without a
+ * log2 call per cell.
  *
  * @tparam DataSource Type satisfying the data source concept (operator(), num_instances(),
  *                    attribute_information via attr_info()).
@@ -155,6 +515,9 @@ double compute_mi(DataSource const &data,
   if (a1_num_values == 1 || a2_num_values == 1) {
     return 0.0;
   }
+  if (detail::use_sparse_joint(a1_num_values, a2_num_values, data.num_instances())) {
+    return detail::compute_mi_sparse(data, info1, info2, attr1, attr2, policy);
+  }
 
   // Per-thread reusable scratch buffer for histogram construction.
   // Intentionally leaked (allocated via new, never freed) to avoid static destruction
@@ -164,92 +527,275 @@ double compute_mi(DataSource const &data,
   // folly SingletonThreadLocal).
   //
   // Each template instantiation (DataSource x Policy) gets its own independent
-  // thread-local buffer. After warmup, the buffer is reused via resize + fill
-  // with zero heap allocation.
-  using histogram_type = typename Policy::histogram_type;
-  static thread_local auto *scratch_ptr = new std::vector<histogram_type>();
-  auto &scratch = *scratch_ptr;
+  // thread-local buffer, as does each counter width below. After warmup, the
+  // buffer is reused via resize + fill with zero heap allocation.
   std::size_t histogram_size = a1_num_values * a2_num_values;
-  scratch.resize(histogram_size);
-  std::fill(scratch.begin(), scratch.end(), histogram_type{});
+  auto zeroed_scratch = [histogram_size](auto counter) -> std::vector<decltype(counter)> & {
+    using count_type = decltype(counter);
+    static thread_local auto *scratch_ptr = new std::vector<count_type>();
+    auto &scratch = *scratch_ptr;
+    scratch.resize(histogram_size);
+    std::fill(scratch.begin(), scratch.end(), count_type{});
+    return scratch;
+  };
 
-  for (std::size_t i = 0; i < data.num_instances(); ++i) {
-    if (policy.include(i)) {
-      policy.accumulate(scratch[data(attr1, i) * a2_num_values + data(attr2, i)], i);
+  // Unweighted counts over contiguous columns go to the cardinality-specialized
+  // kernels, in the narrowest counter type that can hold N; they produce the
+  // same integer histogram as the generic loop.
+  if constexpr (std::is_same_v<Policy, unweighted_policy> &&
+                detail::has_column_data<DataSource>::value) {
+    return detail::with_joint_counter(data.num_instances(), [&](auto counter) {
+      auto &scratch = zeroed_scratch(counter);
+      if (data.num_instances() > 0) {
+        detail::count_joint(data.column_data(attr1), data.column_data(attr2),
+                            data.num_instances(), a1_num_values, a2_num_values, scratch.data());
+      }
+      return detail::mi_from_joint_histogram(scratch.data(), a1_num_values, a2_num_values, info1,
+                                             info2, policy, detail::xlogx_of(data));
+    });
+  } else {
+    auto &scratch = zeroed_scratch(typename Policy::histogram_type{});
+    if constexpr (detail::has_indexed_columns<DataSource>::value) {
+      auto const *column1 = data.source_column(attr1);
+      auto const *column2 = data.source_column(attr2);
+      std::size_t const *index = data.instance_index_data();
+      for (std::size_t i = 0; i < data.num_instances(); ++i) {
+        if (policy.include(i)) {
+          policy.accumulate(scratch[column1[index[i]] * a2_num_values + column2[index[i]]], i);
+        }
+      }
+    } else {
+      for (std::size_t i = 0; i < data.num_instances(); ++i) {
+        if (policy.include(i)) {
+          policy.accumulate(scratch[data(attr1, i) * a2_num_values + data(attr2, i)], i);
+        }
+      }
     }
+    return detail::mi_from_joint_histogram(scratch.data(), a1_num_values, a2_num_values, info1,
+                                           info2, policy, detail::xlogx_of(data));
   }
+}
 
-  // Compute effective sample size from histogram (sum of all bins).
-  // For unweighted/weighted policies this equals N or total_weight.
-  // For pairwise-complete this equals the count of complete pairs.
-  double effective_total = 0;
-  for (std::size_t k = 0; k < histogram_size; ++k) {
-    effective_total += static_cast<double>(scratch[k]);
+/// Maximum attributes per side of a compute_mi_tile tile, and per
+/// compute_mi_batch group.
+inline constexpr std::size_t mi_batch_width = 8;
+
+/// Histogram cells (across all pairs) that one pass of compute_mi_tile may
+/// hold; tiles of high-cardinality attributes are split into several passes.
+inline constexpr std::size_t mi_tile_max_cells = std::size_t{1} << 16;
+
+/**
+ * @brief Compute mutual information for every pair in a tile of attributes.
+ *
+ * Cache-blocked engine behind compute_mi_batch and the tiled
+ * triangular_mi_cache build. Instances are walked in blocks of
+ * detail::joint_histogram_block. For each block, the values of every attribute
+ * in the tile are loaded once — gathered into a small L1/L2-resident buffer
+ * for sources without contiguous columns (e.g., dataset_view's instance
+ * indirection) — and then reused by all rows.size() * cols.size() joint
+ * histograms, so each column segment is read or gathered once per tile rather
+ * than once per pair. Each histogram bin is still accumulated in instance
+ * order, so every value is bit-identical to compute_mi for the same pair.
+ *
+ * When @p rows and @p cols are the same span (a diagonal tile), only pairs
+ * with row position < column position are computed; the other entries of
+ * @p out are left untouched.
+ *
+ * The policy must not depend on the pair of attributes (pairwise_complete_policy
+ * does; call compute_mi per pair instead).
+ *
+ * @tparam InfoLookup Callable mapping an attribute index to its
+ *                    attribute_information const &.
+ * @param data    The data source.
+ * @param info_of Attribute information lookup.
+ * @param rows    Row attributes (at most mi_batch_width).
+ * @param cols    Column attributes (at most mi_batch_width).
+ * @param out     Output, row-major: out[r * cols.size() + c] receives
+ *                I(rows[r]; cols[c]). Must have rows.size() * cols.size() elements.
+ * @param policy  The accumulation policy instance.
+ */
+template <typename DataSource, typename Policy, typename InfoLookup>
+void compute_mi_tile(DataSource const &data, InfoLookup &&info_of,
+                     std::span<std::size_t const> rows, std::span<std::size_t const> cols,
+                     std::span<double> out, Policy const &policy) {
+  using value_type = typename DataSource::value_type;
+  using histogram_type = typename Policy::histogram_type;
+  constexpr bool contiguous = detail::has_column_data<DataSource>::value;
+  // Column segments are contiguous either way (gathered if necessary), so
+  // unweighted tiles always use the specialized counting kernels.
+  constexpr bool integer_kernels = std::is_same_v<Policy, unweighted_policy>;
+  constexpr std::size_t block = detail::joint_histogram_block;
+  assert(rows.size() <= mi_batch_width && cols.size() <= mi_batch_width);
+  assert(out.size() == rows.size() * cols.size());
+
+  bool diagonal = rows.data() == cols.data() && rows.size() == cols.size();
+  std::size_t n = data.num_instances();
+
+  // Column slots: rows first, then columns unless they are the same attributes.
+  std::size_t num_slots = 0;
+  std::array<std::size_t, 2 * mi_batch_width> slot_attr{};
+  for (std::size_t attr : rows) {
+    slot_attr[num_slots++] = attr;
   }
-  if (effective_total == 0) {
-    return 0.0;
+  std::size_t col_slot_base = diagonal ? 0 : num_slots;
+  if (!diagonal) {
+    for (std::size_t attr : cols) {
+      slot_attr[num_slots++] = attr;
+    }
   }
-  double inv_n = 1.0 / effective_total;
 
-  // Derive marginals from the joint histogram when the policy requires it
-  // (e.g., pairwise-complete observations use different subsets per pair).
-  // For unweighted/weighted policies, use the precomputed attribute_information
-  // marginals which are faster (no extra computation).
-  // The trait check is compile-time; the compiler eliminates the unused branch.
-  auto get_marginals = [&]() -> std::pair<std::vector<double>, std::vector<double>> {
-    std::vector<double> m1(a1_num_values, 0.0);
-    std::vector<double> m2(a2_num_values, 0.0);
-    for (std::size_t i = 0; i < a1_num_values; ++i) {
-      for (std::size_t j = 0; j < a2_num_values; ++j) {
-        auto val = static_cast<double>(scratch[i * a2_num_values + j]);
-        m1[i] += val;
-        m2[j] += val;
+  // Pair list; degenerate pairs (a constant attribute) and pairs counted
+  // sparsely are resolved immediately.
+  struct tile_pair {
+    std::size_t row_slot;
+    std::size_t col_slot;
+    std::size_t out_index;
+    std::size_t k1;
+    std::size_t k2;
+  };
+  std::array<tile_pair, mi_batch_width * mi_batch_width> pairs;
+  std::size_t num_pairs = 0;
+  for (std::size_t r = 0; r < rows.size(); ++r) {
+    std::size_t k1 = info_of(rows[r]).num_values();
+    for (std::size_t c = diagonal ? r + 1 : 0; c < cols.size(); ++c) {
+      std::size_t k2 = info_of(cols[c]).num_values();
+      std::size_t out_index = r * cols.size() + c;
+      if (k1 == 1 || k2 == 1) {
+        out[out_index] = 0.0;
+      } else if (detail::use_sparse_joint(k1, k2, data.num_instances())) {
+        // No histogram to share; count this pair on its own.
+        out[out_index] = detail::compute_mi_sparse(data, info_of(rows[r]), info_of(cols[c]),
+                                                   rows[r], cols[c], policy);
+      } else {
+        pairs[num_pairs++] = tile_pair{r, col_slot_base + c, out_index, k1, k2};
       }
     }
-    for (auto &v : m1) {
-      v *= inv_n;
-    }
-    for (auto &v : m2) {
-      v *= inv_n;
-    }
-    return {m1, m2};
-  };
+  }
 
-  double mi = 0.0;
+  // Leaked thread-local scratch, as in compute_mi: the gathered column blocks
+  // of non-contiguous sources and, per counter type, the concatenated
+  // histograms of one pass.
+  static thread_local auto *gathered_ptr = new std::vector<value_type>();
+  auto &gathered = *gathered_ptr;
+  std::array<std::size_t, mi_batch_width * mi_batch_width> offsets{};
+  std::array<value_type const *, 2 * mi_batch_width> segment{};
+  if constexpr (!contiguous) {
+    gathered.resize(num_slots * block);
+  }
 
-  // Check at compile time whether the policy needs pair-specific marginals.
-  // This uses a helper trait with SFINAE to detect the derives_marginals_from_joint flag.
-  // For policies without the flag (unweighted, weighted), the precomputed marginals are used.
-  if (derives_marginals_from_joint_v<Policy>()) {
-    auto marginals = get_marginals();
-    for (std::size_t i = 0; i < a1_num_values; ++i) {
-      for (std::size_t j = 0; j < a2_num_values; ++j) {
-        auto count = scratch[i * a2_num_values + j];
-        double joint_prob = policy.normalize(count, inv_n);
-        if (joint_prob > 0) {
-          mi += joint_prob * std::log2(joint_prob / (marginals.first[i] * marginals.second[j]));
+  auto run_passes = [&](auto counter) {
+    using count_type = decltype(counter);
+    static thread_local auto *scratch_ptr = new std::vector<count_type>();
+    auto &scratch = *scratch_ptr;
+    std::size_t pass_begin = 0;
+    while (pass_begin < num_pairs) {
+      // Take as many pairs as fit the cell budget (always at least one).
+      std::size_t pass_end = pass_begin;
+      std::size_t total_cells = 0;
+      while (pass_end < num_pairs) {
+        std::size_t cells = pairs[pass_end].k1 * pairs[pass_end].k2;
+        if (pass_end > pass_begin && total_cells + cells > mi_tile_max_cells) {
+          break;
         }
+        offsets[pass_end] = total_cells;
+        total_cells += cells;
+        ++pass_end;
       }
-    }
-  } else {
-    using value_type = typename DataSource::value_type;
-    for (std::size_t i = 0; i < a1_num_values; ++i) {
-      for (std::size_t j = 0; j < a2_num_values; ++j) {
-        auto count = scratch[i * a2_num_values + j];
-        double joint_prob = policy.normalize(count, inv_n);
-        if (joint_prob > 0) {
-          // i and j are bounded by a1/a2_num_values, themselves bounded
-          // by the storage type T's domain (asserted to fit in [0, 255]),
-          // so the narrowing cast to T is value-preserving.
-          double marginal_i = info1.marginal_probability(static_cast<value_type>(i));
-          double marginal_j = info2.marginal_probability(static_cast<value_type>(j));
-          mi += joint_prob * std::log2(joint_prob / (marginal_i * marginal_j));
+
+      scratch.resize(total_cells);
+      std::fill(scratch.begin(), scratch.end(), count_type{});
+
+      for (std::size_t begin = 0; begin < n; begin += block) {
+        std::size_t len = std::min(block, n - begin);
+        for (std::size_t s = 0; s < num_slots; ++s) {
+          if constexpr (contiguous) {
+            segment[s] = data.column_data(slot_attr[s]) + begin;
+          } else if constexpr (detail::has_indexed_columns<DataSource>::value) {
+            value_type const *column = data.source_column(slot_attr[s]);
+            std::size_t const *index = data.instance_index_data() + begin;
+            value_type *dst = gathered.data() + s * block;
+            for (std::size_t i = 0; i < len; ++i) {
+              dst[i] = column[index[i]];
+            }
+            segment[s] = dst;
+          } else {
+            value_type *dst = gathered.data() + s * block;
+            for (std::size_t i = 0; i < len; ++i) {
+              dst[i] = data(slot_attr[s], begin + i);
+            }
+            segment[s] = dst;
+          }
+        }
+
+        for (std::size_t p = pass_begin; p < pass_end; ++p) {
+          auto const &pair = pairs[p];
+          count_type *hist = scratch.data() + offsets[p];
+          value_type const *values1 = segment[pair.row_slot];
+          value_type const *values2 = segment[pair.col_slot];
+          if constexpr (integer_kernels) {
+            detail::count_joint(values1, values2, len, pair.k1, pair.k2, hist);
+          } else {
+            for (std::size_t i = 0; i < len; ++i) {
+              if (policy.include(begin + i)) {
+                policy.accumulate(hist[values1[i] * pair.k2 + values2[i]], begin + i);
+              }
+            }
+          }
         }
       }
+
+      for (std::size_t p = pass_begin; p < pass_end; ++p) {
+        auto const &pair = pairs[p];
+        out[pair.out_index] = detail::mi_from_joint_histogram(
+            scratch.data() + offsets[p], pair.k1, pair.k2, info_of(slot_attr[pair.row_slot]),
+            info_of(slot_attr[pair.col_slot]), policy, detail::xlogx_of(data));
+      }
+      pass_begin = pass_end;
     }
+  };
+  // Integer counts use the narrowest counter type that can hold N, so more of
+  // a pass's histograms stay cache-resident.
+  if constexpr (integer_kernels) {
+    detail::with_joint_counter(n, run_passes);
+  } else {
+    run_passes(histogram_type{});
   }
+}
 
-  return mi;
+/**
+ * @brief Compute mutual information between one attribute and a batch of others.
+ *
+ * Equivalent to calling compute_mi(data, info1, info_of(attrs[c]), attr1,
+ * attrs[c], policy) for every c, and bit-identical to it. The partners are
+ * processed in groups of mi_batch_width as one-row tiles of compute_mi_tile, so
+ * each block of the fixed attribute is read (or gathered) once per group
+ * instead of once per pair.
+ *
+ * @tparam InfoLookup Callable mapping an attribute index to its
+ *                    attribute_information const &.
+ * @param data    The data source.
+ * @param info1   Attribute information for @p attr1.
+ * @param info_of Attribute information lookup for the attributes in @p attrs.
+ * @param attr1   Index of the fixed attribute.
+ * @param attrs   Indices of the other attributes.
+ * @param out     Output; out[c] receives I(attr1; attrs[c]). Must have attrs.size() elements.
+ * @param policy  The accumulation policy instance.
+ */
+template <typename DataSource, typename Policy, typename InfoLookup>
+void compute_mi_batch(DataSource const &data,
+                      attribute_information<typename DataSource::value_type> const &info1,
+                      InfoLookup &&info_of, std::size_t attr1, std::span<std::size_t const> attrs,
+                      std::span<double> out, Policy const &policy) {
+  using info_type = attribute_information<typename DataSource::value_type>;
+  auto lookup = [&](std::size_t attr) -> info_type const & {
+    return attr == attr1 ? info1 : info_of(attr);
+  };
+  std::span<std::size_t const> row(&attr1, 1);
+  for (std::size_t begin = 0; begin < attrs.size(); begin += mi_batch_width) {
+    std::size_t len = std::min(mi_batch_width, attrs.size() - begin);
+    compute_mi_tile(data, lookup, row, attrs.subspan(begin, len), out.subspan(begin, len),
+                    policy);
+  }
 }
 
 #endif
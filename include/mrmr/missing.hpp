@@ -14,8 +14,9 @@
 /**
  * @brief Sentinel value indicating a missing discrete observation.
  *
- * For unsigned char storage, value 255 is reserved as the missing sentinel.
- * This reduces the representable value range to [0, 254] (255 distinct values).
+ * The largest value of the storage type is reserved as the missing sentinel
+ * (255 for unsigned char, 65535 for std::uint16_t), which reduces the
+ * representable value range to [0, T::max() - 1].
  * All MI computation and imputation routines use this constant to identify
  * missing data.
  */
@@ -90,7 +91,7 @@ void validate_no_missing(T const *data, std::size_t num_attrs, std::size_t num_i
  * If all instances of an attribute are missing, they are left unchanged
  * (sentinel preserved) since no observed values exist to derive a mode from.
  *
- * @tparam T Value type (must be unsigned integer with max <= 255).
+ * @tparam T Value type (unsigned integer of at most 16 bits).
  * @param data         Column-major data (modified in place).
  * @param num_attrs    Number of attributes.
  * @param num_insts    Number of instances.
@@ -14,9 +14,11 @@
 #include <locale>
 #include <mrmr/attribute_information.hpp>
 #include <mrmr/detail/delimiter_ctype.hpp>
+#include <mrmr/detail/joint_histogram.hpp>
 #include <mrmr/ksg_estimator.hpp>
 #include <mrmr/mi_policy.hpp>
 #include <random>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -85,7 +87,7 @@ public:
 
   std::size_t num_instances() const { return _num_instances; }
   std::size_t num_attributes() const { return _names.size(); }
-  std::string attribute_name(std::size_t attr) const { return _names[attr]; }
+  std::string const &attribute_name(std::size_t attr) const { return _names[attr]; }
   column_type type_of(std::size_t attr) const { return _col_types[attr]; }
   std::size_t ksg_k() const { return _ksg_k; }
 
@@ -105,6 +107,19 @@ public:
    */
   double mutual_information(std::size_t attr1, std::size_t attr2) const;
 
+  /**
+   * @brief Compute MI between one attribute and a batch of others.
+   *
+   * Equivalent to out[c] = mutual_information(attr, others[c]) for every c,
+   * with identical results. When @p attr is discrete, its discrete partners
+   * share one batched histogram pass (see compute_mi_batch); KSG and Ross
+   * pairs are computed one at a time.
+   *
+   * @throws std::logic_error If out.size() != others.size().
+   */
+  void mutual_information_batch(std::size_t attr, std::span<std::size_t const> others,
+                                std::span<double> out) const;
+
   /**
    * @brief Access a single cell value as double.
    *
@@ -122,6 +137,20 @@ public:
 private:
   friend mixed_dataset bootstrap_resample(mixed_dataset const &, std::mt19937 &);
 
+  // Presents the discrete columns, indexed by discrete column index, as a
+  // data source with contiguous columns for compute_mi_batch.
+  struct discrete_columns {
+    using value_type = unsigned char;
+    mixed_dataset const *owner;
+    std::size_t num_instances() const { return owner->_num_instances; }
+    unsigned char const *column_data(std::size_t col) const {
+      return owner->_discrete_cols[col].data();
+    }
+    unsigned char operator()(std::size_t col, std::size_t inst) const {
+      return owner->_discrete_cols[col][inst];
+    }
+  };
+
   void parse_header(std::istream &is);
   void build_storage(std::vector<double> const &row_major);
   void compute_statistics();
@@ -332,25 +361,19 @@ inline double mixed_dataset::mutual_information(std::size_t attr1, std::size_t a
       return 0.0;
     }
 
-    std::vector<std::size_t> scratch(k1 * k2, 0);
-    for (std::size_t i = 0; i < _num_instances; ++i) {
-      ++scratch[col1[i] * k2 + col2[i]];
-    }
-
-    double inv_n = 1.0 / static_cast<double>(_num_instances);
-    double mi = 0.0;
-    for (std::size_t i = 0; i < k1; ++i) {
-      for (std::size_t j = 0; j < k2; ++j) {
-        std::size_t count = scratch[i * k2 + j];
-        if (count != 0) {
-          double jp = static_cast<double>(count) * inv_n;
-          double mi_val = info1.marginal_probability(i);
-          double mj_val = info2.marginal_probability(j);
-          mi += jp * std::log2(jp / (mi_val * mj_val));
-        }
-      }
+    if (detail::use_sparse_joint(k1, k2, _num_instances)) {
+      auto code_of = [&col1, &col2, k2](std::size_t i) {
+        return std::size_t{col1[i]} * k2 + col2[i];
+      };
+      return detail::mi_from_sparse_joint(code_of, _num_instances, k1, k2, info1, info2,
+                                          unweighted_policy{});
     }
-    return mi;
+    return detail::with_joint_counter(_num_instances, [&](auto counter) {
+      std::vector<decltype(counter)> scratch(k1 * k2, 0);
+      detail::count_joint(col1.data(), col2.data(), _num_instances, k1, k2, scratch.data());
+      return detail::mi_from_joint_histogram(scratch.data(), k1, k2, info1, info2,
+                                             unweighted_policy{});
+    });
 
   } else if (t1 == column_type::CONTINUOUS && t2 == column_type::CONTINUOUS) {
     // KSG MI
@@ -384,6 +407,44 @@ inline double mixed_dataset::mutual_information(std::size_t attr1, std::size_t a
   }
 }
 
+inline void mixed_dataset::mutual_information_batch(std::size_t attr,
+                                                    std::span<std::size_t const> others,
+                                                    std::span<double> out) const {
+  if (out.size() != others.size()) {
+    throw std::logic_error("mutual_information_batch output size must equal the number of others");
+  }
+  if (_col_types[attr] != column_type::DISCRETE) {
+    for (std::size_t c = 0; c < others.size(); ++c) {
+      out[c] = mutual_information(attr, others[c]);
+    }
+    return;
+  }
+
+  // Batch the discrete partners on discrete column indices; KSG/Ross pairs
+  // have no histogram to share and are computed directly.
+  std::vector<std::size_t> discrete_others;
+  std::vector<std::size_t> positions;
+  for (std::size_t c = 0; c < others.size(); ++c) {
+    if (_col_types[others[c]] == column_type::DISCRETE) {
+      discrete_others.push_back(_discrete_col_index[others[c]]);
+      positions.push_back(c);
+    } else {
+      out[c] = mutual_information(attr, others[c]);
+    }
+  }
+  std::vector<double> discrete_out(discrete_others.size());
+  std::size_t col = _discrete_col_index[attr];
+  compute_mi_batch(
+      discrete_columns{this}, _discrete_info[col],
+      [this](std::size_t c) -> attribute_information<unsigned char> const & {
+        return _discrete_info[c];
+      },
+      col, discrete_others, discrete_out, unweighted_policy{});
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    out[positions[i]] = discrete_out[i];
+  }
+}
+
 #endif // MRMR_HAS_CONTINUOUS
 
 #endif // MRMR_MIXED_DATASET_HPP
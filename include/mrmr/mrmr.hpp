@@ -5,42 +5,63 @@
 #define MRMR_MRMR_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
-#include <forward_list>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <mrmr/dataset.hpp>
+#include <mrmr/detail/parallel.hpp>
+#include <mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+// Owning data sources defined in optional headers, for the deleted rvalue
+// overloads of mrmr().
+template <typename FloatT> class continuous_dataset;
+class mixed_dataset;
+
 /**
  * @brief Return type for a complete mRMR feature ranking.
  *
  * A tuple of six parallel vectors, each with one entry per ranked attribute:
  * - [0] ranks           — 0-based rank positions (0 = class attribute).
  * - [1] attribute indices — original attribute column indices in the dataset.
- * - [2] attribute names  — attribute name strings.
+ * - [2] attribute names  — views of the data source's attribute names.
  * - [3] entropies        — Shannon entropy of each attribute in bits.
  * - [4] mutual_informations — MI with the class attribute in bits.
  * - [5] mrmr_scores      — final mRMR relevance-minus-redundancy score.
+ *
+ * Names are not copied: each entry of [2] refers to the name stored in the
+ * data source passed to mrmr() and is valid as long as that data source is.
+ * Each vector is reserved once, so recording a rank allocates nothing.
  */
 using mrmr_return_type =
-    std::tuple<std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::string>,
+    std::tuple<std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::string_view>,
                std::vector<double>, std::vector<double>, std::vector<double>>;
 
 /**
- * @brief Optional callback invoked once per ranked attribute during mRMR selection.
+ * @brief Type-erased rank sink for mrmr().
  *
- * Enables streaming output of results without buffering the full return tuple.
- * The parameters correspond to: rank, attribute_index, name, entropy,
- * mutual_information_with_class, mrmr_score.
+ * mrmr() accepts any callable with this signature directly; this alias is for
+ * callers that need to choose the sink at run time. The parameters correspond
+ * to: rank, attribute_index, name, entropy, mutual_information_with_class,
+ * mrmr_score. The name views the data source's attribute name; copy it to
+ * keep it beyond the data source.
  */
 using mrmr_rank_callback =
-    std::function<void(std::size_t, std::size_t, std::string const &, double, double, double)>;
+    std::function<void(std::size_t, std::size_t, std::string_view, double, double, double)>;
 
 /**
  * @brief Default threshold for precomputing the pairwise MI cache.
@@ -54,6 +75,46 @@ using mrmr_rank_callback =
  */
 constexpr std::size_t MRMR_DEFAULT_CACHE_THRESHOLD = 5000;
 
+/**
+ * @brief Default byte budget of the lazy per-attribute MI row cache.
+ *
+ * Used by mrmre() when M exceeds the triangular cache threshold; see
+ * lazy_mi_cache. At M = 1,000,000 useful attributes, 256 MiB holds 33 rows.
+ */
+constexpr std::size_t MRMR_DEFAULT_LAZY_CACHE_BYTES = std::size_t{256} << 20;
+
+namespace detail {
+
+/// Whether mrmr() should call @p sink: false for nullptr and for empty
+/// std::function objects or null function pointers.
+template <typename Sink> bool is_active_rank_sink(Sink const &sink) {
+  if constexpr (std::is_null_pointer_v<Sink>) {
+    return false;
+  } else if constexpr (std::is_constructible_v<bool, Sink const &>) {
+    return static_cast<bool>(sink);
+  } else {
+    return true;
+  }
+}
+
+// Traits to detect data sources that provide the batched (one-vs-many) and
+// tiled (many-vs-many) MI entry points.
+template <typename D, typename = void> struct has_mutual_information_batch : std::false_type {};
+template <typename D>
+struct has_mutual_information_batch<
+    D, std::void_t<decltype(std::declval<D const &>().mutual_information_batch(
+           std::size_t{}, std::span<std::size_t const>{}, std::span<double>{}))>>
+    : std::true_type {};
+
+template <typename D, typename = void> struct has_mutual_information_tile : std::false_type {};
+template <typename D>
+struct has_mutual_information_tile<
+    D, std::void_t<decltype(std::declval<D const &>().mutual_information_tile(
+           std::span<std::size_t const>{}, std::span<std::size_t const>{},
+           std::span<double>{}))>> : std::true_type {};
+
+} // namespace detail
+
 /**
  * @brief Precomputed upper-triangular pairwise MI cache for efficient O(1) lookup.
  *
@@ -74,13 +135,30 @@ public:
    * Builds a mapping from original attribute indices to dense indices and
    * precomputes MI for every unique pair (i, j) with i < j.
    *
+   * When DataSource provides mutual_information_tile() (dataset, dataset_view),
+   * the triangle is built from square tiles of mi_batch_width attributes on and
+   * above the diagonal: each tile loads every block of instances of its columns
+   * once (gathering through a view's instance indirection into an L2-resident
+   * buffer) and fills all of its pairs from it. Other data sources compute
+   * each pair with mutual_information().
+   *
+   * With @p num_threads != 1 the tiles (or, without tiling, the rows of the
+   * triangle) are distributed over a thread pool and claimed dynamically one
+   * at a time, so uneven work per tile or row balances across threads. Tiled
+   * and per-pair values are bit-identical, and every cell is written by exactly
+   * one task, so the cache contents do not depend on the strategy or thread
+   * count. This requires the MI entry points to be safe for concurrent calls.
+   *
    * @param data         Dataset providing the mutual_information() method.
    * @param attr_indices Indices of the attributes to cache; must be valid
    *                     indices into @p data.
+   * @param num_threads  Number of threads used to fill the cache
+   *                     (1 = serial, 0 = hardware concurrency).
    * @throws std::length_error If attr_indices.size() is too large for
    *                           triangular indexing with std::size_t arithmetic.
    */
-  triangular_mi_cache(DataSource const &data, std::vector<std::size_t> const &attr_indices)
+  triangular_mi_cache(DataSource const &data, std::vector<std::size_t> const &attr_indices,
+                      std::size_t num_threads = 1)
       : _m(attr_indices.size()) {
     // Guard against overflow in triangular indexing for very large M
     if (_m >= 2) {
@@ -97,12 +175,25 @@ public:
       _to_dense[attr_indices[i]] = i;
     }
 
-    // Precompute MI for all unique pairs
     _cache.resize(_m * (_m - 1) / 2);
-    for (std::size_t i = 0; i < _m; ++i) {
-      for (std::size_t j = i + 1; j < _m; ++j) {
-        _cache[tri_index(i, j)] = data.mutual_information(attr_indices[i], attr_indices[j]);
+    if constexpr (detail::has_mutual_information_tile<DataSource>::value) {
+      fill_tiled(data, attr_indices, num_threads);
+      return;
+    }
+
+    // Precompute MI for all unique pairs. Each row writes a disjoint contiguous
+    // range of _cache, so rows can be filled concurrently without synchronization.
+    auto fill_rows = [&](std::size_t row_begin, std::size_t row_end) {
+      for (std::size_t i = row_begin; i < row_end; ++i) {
+        for (std::size_t j = i + 1; j < _m; ++j) {
+          _cache[tri_index(i, j)] = data.mutual_information(attr_indices[i], attr_indices[j]);
+        }
       }
+    };
+    if (num_threads == 1 || _m < 3) {
+      fill_rows(0, _m);
+    } else {
+      detail::parallel_for(num_threads, _m, 1, fill_rows);
     }
   }
 
@@ -131,6 +222,50 @@ public:
   }
 
 private:
+  void fill_tiled(DataSource const &data, std::vector<std::size_t> const &attr_indices,
+                  std::size_t num_threads) {
+    // Tiles (I, J) with J >= I over blocks of mi_batch_width dense indices.
+    // Each tile writes a disjoint set of cells, so tiles can be filled
+    // concurrently without synchronization.
+    constexpr std::size_t width = mi_batch_width;
+    std::size_t num_blocks = (_m + width - 1) / width;
+    std::vector<std::pair<std::size_t, std::size_t>> tiles;
+    tiles.reserve(num_blocks * (num_blocks + 1) / 2);
+    for (std::size_t row_block = 0; row_block < num_blocks; ++row_block) {
+      for (std::size_t col_block = row_block; col_block < num_blocks; ++col_block) {
+        tiles.emplace_back(row_block, col_block);
+      }
+    }
+
+    std::span<std::size_t const> indices(attr_indices);
+    auto fill = [&](std::size_t tile_begin, std::size_t tile_end) {
+      std::array<double, width * width> out{};
+      for (std::size_t t = tile_begin; t < tile_end; ++t) {
+        std::size_t row_base = tiles[t].first * width;
+        std::size_t col_base = tiles[t].second * width;
+        std::size_t num_rows = std::min(width, _m - row_base);
+        std::size_t num_cols = std::min(width, _m - col_base);
+        auto rows = indices.subspan(row_base, num_rows);
+        // Diagonal tiles pass the same span twice, so only i < j is computed.
+        auto cols = row_base == col_base ? rows : indices.subspan(col_base, num_cols);
+        data.mutual_information_tile(rows, cols,
+                                     std::span<double>(out.data(), num_rows * num_cols));
+        for (std::size_t r = 0; r < num_rows; ++r) {
+          for (std::size_t c = 0; c < num_cols; ++c) {
+            if (row_base + r < col_base + c) {
+              _cache[tri_index(row_base + r, col_base + c)] = out[r * num_cols + c];
+            }
+          }
+        }
+      }
+    };
+    if (num_threads == 1 || tiles.size() < 2) {
+      fill(0, tiles.size());
+    } else {
+      detail::parallel_for(num_threads, tiles.size(), 1, fill);
+    }
+  }
+
   std::size_t tri_index(std::size_t i, std::size_t j) const {
     return i * (2 * _m - i - 1) / 2 + (j - i - 1);
   }
@@ -140,64 +275,477 @@ private:
   std::vector<double> _cache;
 };
 
+namespace detail {
+
+/**
+ * @brief On-the-fly MI lookup for mrmr_selection_loop.
+ *
+ * Offers both the per-pair and the batched lookup form. The batched form
+ * forwards to DataSource::mutual_information_batch() when the data source
+ * provides it and falls back to one mutual_information() call per partner
+ * otherwise (e.g., continuous_dataset, where KSG shares no work across pairs).
+ */
+template <typename DataSource> class on_the_fly_mi {
+public:
+  explicit on_the_fly_mi(DataSource const &data) : _data(data) {}
+
+  double operator()(std::size_t a1, std::size_t a2) const {
+    return _data.mutual_information(a1, a2);
+  }
+
+  void operator()(std::size_t attribute, std::span<std::size_t const> others,
+                  std::span<double> out) const {
+    if constexpr (has_mutual_information_batch<DataSource>::value) {
+      _data.mutual_information_batch(attribute, others, out);
+    } else {
+      for (std::size_t c = 0; c < others.size(); ++c) {
+        out[c] = _data.mutual_information(attribute, others[c]);
+      }
+    }
+  }
+
+private:
+  DataSource const &_data;
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily filled, memory-bounded MI cache of per-attribute rows.
+ *
+ * Third strategy between the full triangular_mi_cache and pure on-the-fly MI,
+ * for M too large for the triangle. Each selection step of mRMR needs MI
+ * between the last selected attribute and the remaining candidates, i.e. part
+ * of that attribute's row. Rows are allocated on first use (one double per
+ * cached attribute, NaN = not yet computed), missing entries are computed in
+ * one batched call, and rows are kept until the byte budget forces the
+ * least recently used ones out. Repeated selections of the same attribute —
+ * typical across the solutions of an exhaustive mRMRe ensemble, which share
+ * most of their selections — then cost O(k) lookups instead of O(k * N).
+ *
+ * Lookups use the row of the first (fixed) attribute only, so every value is
+ * exactly what the on-the-fly path would compute for the same call and
+ * rankings do not depend on the cache. If the budget cannot hold a single row,
+ * nothing is cached and every call is computed on the fly.
+ *
+ * Concurrent calls are safe as long as calls that overlap in time either use
+ * different fixed attributes or disjoint @p others, which is how
+ * mrmr_selection_loop splits each rank across threads.
+ *
+ * @tparam DataSource Data source providing mutual_information() and, optionally,
+ *                    mutual_information_batch().
+ */
+template <typename DataSource> class lazy_mi_cache {
+public:
+  /**
+   * @brief Create an empty cache.
+   *
+   * @param data         Data source (must outlive the cache).
+   * @param attr_indices Attributes that may appear in lookups; rows hold one
+   *                     entry per attribute in this list.
+   * @param byte_budget  Maximum bytes of row storage kept at any time.
+   */
+  lazy_mi_cache(DataSource const &data, std::vector<std::size_t> const &attr_indices,
+                std::size_t byte_budget)
+      : _compute(data), _m(attr_indices.size()),
+        _max_rows(_m == 0 ? 0 : byte_budget / (_m * sizeof(double))) {
+    _to_dense.assign(data.num_attributes(), std::numeric_limits<std::size_t>::max());
+    for (std::size_t i = 0; i < _m; ++i) {
+      _to_dense[attr_indices[i]] = i;
+    }
+    _rows.resize(_m);
+  }
+
+  /** @brief Return MI between @p a1 and @p a2, computing it on first use. */
+  double operator()(std::size_t a1, std::size_t a2) {
+    double mi = 0.0;
+    (*this)(a1, std::span<std::size_t const>(&a2, 1), std::span<double>(&mi, 1));
+    return mi;
+  }
+
+  /**
+   * @brief Fill out[c] with MI between @p attribute and others[c].
+   *
+   * Entries already in the row of @p attribute are copied; the rest are
+   * computed with one batched call and stored.
+   */
+  void operator()(std::size_t attribute, std::span<std::size_t const> others,
+                  std::span<double> out) {
+    std::shared_ptr<std::vector<double>> row = acquire_row(attribute);
+    if (!row) {
+      _compute(attribute, others, out);
+      _computed.fetch_add(others.size(), std::memory_order_relaxed);
+      return;
+    }
+
+    // Leaked thread-local scratch, as in compute_mi.
+    struct miss_scratch {
+      std::vector<std::size_t> attrs;
+      std::vector<std::size_t> positions;
+      std::vector<double> values;
+    };
+    static thread_local auto *scratch_ptr = new miss_scratch();
+    auto &missing = scratch_ptr->attrs;
+    auto &missing_pos = scratch_ptr->positions;
+    auto &missing_out = scratch_ptr->values;
+    missing.clear();
+    missing_pos.clear();
+    for (std::size_t c = 0; c < others.size(); ++c) {
+      double cached = (*row)[_to_dense[others[c]]];
+      if (std::isnan(cached)) {
+        missing.push_back(others[c]);
+        missing_pos.push_back(c);
+      } else {
+        out[c] = cached;
+      }
+    }
+    if (missing.empty()) {
+      return;
+    }
+    missing_out.resize(missing.size());
+    _compute(attribute, missing, missing_out);
+    for (std::size_t i = 0; i < missing.size(); ++i) {
+      (*row)[_to_dense[missing[i]]] = missing_out[i];
+      out[missing_pos[i]] = missing_out[i];
+    }
+    _computed.fetch_add(missing.size(), std::memory_order_relaxed);
+  }
+
+  /** @brief Return the number of MI values computed (cache misses) so far. */
+  std::size_t computed_pairs() const { return _computed.load(std::memory_order_relaxed); }
+
+  /** @brief Return the number of rows currently held. */
+  std::size_t cached_rows() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _held.size();
+  }
+
+private:
+  struct row_entry {
+    std::shared_ptr<std::vector<double>> values;
+    std::size_t last_use = 0;
+  };
+
+  // Return the row of attribute, creating it (and evicting least recently used
+  // rows to stay within budget) if needed. Returns null when no row fits.
+  std::shared_ptr<std::vector<double>> acquire_row(std::size_t attribute) {
+    if (_max_rows == 0) {
+      return nullptr;
+    }
+    std::size_t dense = _to_dense[attribute];
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_clock;
+    auto &entry = _rows[dense];
+    if (!entry.values) {
+      while (_held.size() >= _max_rows) {
+        auto victim = std::min_element(_held.begin(), _held.end(), [this](auto a, auto b) {
+          return _rows[a].last_use < _rows[b].last_use;
+        });
+        _rows[*victim].values.reset();
+        *victim = _held.back();
+        _held.pop_back();
+      }
+      entry.values =
+          std::make_shared<std::vector<double>>(_m, std::numeric_limits<double>::quiet_NaN());
+      _held.push_back(dense);
+    }
+    entry.last_use = _clock;
+    return entry.values;
+  }
+
+  detail::on_the_fly_mi<DataSource> _compute;
+  std::size_t _m;
+  std::size_t _max_rows;
+  std::vector<std::size_t> _to_dense;
+  mutable std::mutex _mutex;
+  std::vector<row_entry> _rows;  // indexed by dense attribute index
+  std::vector<std::size_t> _held; // dense indices whose rows are allocated
+  std::size_t _clock = 0;
+  std::atomic<std::size_t> _computed{0};
+};
+
+/**
+ * @brief Unselected attributes of an mRMR selection, stored by position.
+ *
+ * attributes[p] is the p-th candidate in scan order; relevance[p] is its MI
+ * with the class and redundance[p] the MI accumulated against the attributes
+ * selected so far. The three arrays are contiguous and parallel, so a rank
+ * of the selection loop streams through them instead of chasing list nodes
+ * or indexing attribute-sized arrays.
+ */
+struct mrmr_candidates {
+  std::vector<std::size_t> attributes;
+  std::vector<double> relevance;
+  std::vector<double> redundance;
+
+  /** @brief Reserve room for @p n candidates. */
+  void reserve(std::size_t n) {
+    attributes.reserve(n);
+    relevance.reserve(n);
+    redundance.reserve(n);
+  }
+
+  /** @brief Append a candidate with no accumulated redundance. */
+  void push_back(std::size_t attribute, double mi_with_class) {
+    attributes.push_back(attribute);
+    relevance.push_back(mi_with_class);
+    redundance.push_back(0.0);
+  }
+
+  /**
+   * @brief Remove the candidate at position @p pos, keeping the others in order.
+   *
+   * The scan order decides ties, so candidates are compacted rather than
+   * swap-removed.
+   */
+  void erase(std::size_t pos) {
+    auto offset = static_cast<std::ptrdiff_t>(pos);
+    attributes.erase(attributes.begin() + offset);
+    relevance.erase(relevance.begin() + offset);
+    redundance.erase(redundance.begin() + offset);
+  }
+
+  std::size_t size() const { return attributes.size(); }
+  bool empty() const { return attributes.empty(); }
+};
+
 /**
  * @brief Core mRMR selection loop, templated on the MI lookup callable.
  *
  * Iteratively selects the unselected attribute with the highest
- * relevance-minus-redundancy score until no unselected attributes remain.
+ * relevance-minus-redundancy score until no unselected attributes remain or
+ * rank @p max_rank has been assigned. Stopping early leaves the remaining
+ * attributes in @p candidates, so a top-k ranking costs O(k * M) MI lookups
+ * instead of O(M^2).
  * Templating on @p MILookup allows compile-time specialization for both cached
  * (O(1)) and on-the-fly (O(N)) MI computation without runtime dispatch overhead
  * in the hot loop.
  *
+ * Each rank updates the redundance of every candidate and scores it in
+ * position order; the first candidate whose score beats the best so far by
+ * more than epsilon wins, and is then removed from @p candidates by stable
+ * compaction. Ties therefore go to the earliest candidate in the initial
+ * order, whatever the thread count.
+ *
+ * With @p num_threads != 1 each rank is evaluated by a parallel engine: the
+ * candidate positions are split into chunks, and worker threads update
+ * redundance and compute the mRMR score of every candidate in their chunk.
+ * Each candidate's redundance entry is touched by exactly one thread, so no
+ * synchronization is needed. The winner is then chosen by a serial scan over
+ * the scores in position order using the same epsilon comparison as the
+ * serial loop. The epsilon rule is order-dependent (it is not an associative
+ * reduction), so merging per-chunk winners could pick a different attribute
+ * on near-ties; the serial scan is O(M) with no MI calls and keeps the
+ * output, including tie-breaking, identical to the serial loop. This pays
+ * off when @p get_mi is expensive (on-the-fly MI); for O(1) cached lookups the
+ * thread hand-off costs more than it saves, so callers should pass 1.
+ *
+ * If @p get_mi is also invocable as void(size_t a, span<size_t const> others,
+ * span<double> out), each chunk of candidates is evaluated with one batched
+ * call (see dataset::mutual_information_batch) through the same engine, even
+ * when @p num_threads == 1. Batched and per-pair lookups return identical MI
+ * values, so the ranking is unchanged.
+ *
  * @tparam MILookup    Callable with signature double(size_t, size_t) returning
- *                     MI between two attribute indices.
+ *                     MI between two attribute indices, optionally also
+ *                     invocable in the batched form above. Must be safe for
+ *                     concurrent calls when @p num_threads != 1.
  * @tparam OnSelected  Callable with signature void(size_t rank, size_t attr_index,
- *                     double mrmr_score) invoked after each selection.
- * @param mutual_informations  Per-attribute MI with the class (indexed by attribute index).
- * @param redundance           Accumulated redundance accumulator (updated in-place).
- * @param unselected           Forward list of attribute indices not yet selected
- *                             (modified in-place; selected attribute is erased).
+ *                     double mrmr_score) invoked after each selection. Always
+ *                     invoked on the calling thread.
+ * @param candidates           Attributes not yet selected, in scan order, with their
+ *                             relevance and accumulated redundance (modified in-place;
+ *                             selected attributes are removed).
  * @param last_attribute_index Index of the most recently selected attribute.
  * @param start_rank           Rank value assigned to the first selection in this call.
  * @param get_mi               MI lookup callable.
  * @param on_selected          Callback invoked once per selected attribute.
+ * @param num_threads          Threads used to scan candidates
+ *                             (1 = serial, 0 = hardware concurrency).
+ * @param max_rank             Last rank to assign; selection stops once it has
+ *                             been emitted (default: no limit).
  */
 template <typename MILookup, typename OnSelected>
-void mrmr_selection_loop(std::vector<double> const &mutual_informations,
-                         std::vector<double> &redundance,
-                         std::forward_list<std::size_t> &unselected,
-                         std::size_t last_attribute_index, std::size_t start_rank,
-                         MILookup &&get_mi, OnSelected &&on_selected) {
+void mrmr_selection_loop(mrmr_candidates &candidates, std::size_t last_attribute_index,
+                         std::size_t start_rank, MILookup &&get_mi, OnSelected &&on_selected,
+                         std::size_t num_threads = 1,
+                         std::size_t max_rank = std::numeric_limits<std::size_t>::max()) {
   assert(start_rank >= 2 && "start_rank must be >= 2 to avoid division by zero in redundance");
   std::size_t rank = start_rank;
-  while (!unselected.empty()) {
+
+  constexpr bool batched = std::is_invocable_v<MILookup &, std::size_t,
+                                               std::span<std::size_t const>, std::span<double>>;
+  if (num_threads != 1 || batched) {
+    detail::thread_pool pool(num_threads);
+    std::vector<double> scores;
+    while (!candidates.empty() && rank <= max_rank) {
+      std::size_t const *attributes = candidates.attributes.data();
+      double const *relevance = candidates.relevance.data();
+      double *redundance = candidates.redundance.data();
+      auto divisor = static_cast<double>(rank - 1);
+      scores.resize(candidates.size());
+
+      // Roughly four chunks per thread so threads that draw cheap candidates
+      // (e.g., low-cardinality pairs) pick up more of the remaining work, but
+      // never fewer candidates than one full MI batch.
+      std::size_t grain =
+          std::max<std::size_t>(mi_batch_width, candidates.size() / (4 * pool.size()));
+      pool.parallel_for(candidates.size(), grain, [&](std::size_t begin, std::size_t end) {
+        if constexpr (batched) {
+          // scores[begin, end) first receives the raw MI values.
+          get_mi(last_attribute_index,
+                 std::span<std::size_t const>(attributes + begin, end - begin),
+                 std::span<double>(scores).subspan(begin, end - begin));
+          for (std::size_t pos = begin; pos < end; ++pos) {
+            redundance[pos] += scores[pos];
+            scores[pos] = relevance[pos] - redundance[pos] / divisor;
+          }
+        } else {
+          for (std::size_t pos = begin; pos < end; ++pos) {
+            redundance[pos] += get_mi(last_attribute_index, attributes[pos]);
+            scores[pos] = relevance[pos] - redundance[pos] / divisor;
+          }
+        }
+      });
+
+      double best_mrmr_score = -std::numeric_limits<double>::infinity();
+      std::size_t best_pos = 0;
+      for (std::size_t pos = 0; pos < scores.size(); ++pos) {
+        if (scores[pos] - best_mrmr_score > std::numeric_limits<double>::epsilon()) {
+          best_mrmr_score = scores[pos];
+          best_pos = pos;
+        }
+      }
+      std::size_t best_attribute_index = attributes[best_pos];
+
+      on_selected(rank, best_attribute_index, best_mrmr_score);
+
+      candidates.erase(best_pos);
+      last_attribute_index = best_attribute_index;
+      ++rank;
+    }
+    return;
+  }
+
+  while (!candidates.empty() && rank <= max_rank) {
+    std::size_t const *attributes = candidates.attributes.data();
+    double const *relevance = candidates.relevance.data();
+    double *redundance = candidates.redundance.data();
+    auto divisor = static_cast<double>(rank - 1);
     double best_mrmr_score = -std::numeric_limits<double>::infinity();
-    std::size_t best_attribute_index = 0;
-    auto it = std::cbegin(unselected);
-    auto last_it = unselected.before_begin();
-    auto erase_it = last_it;
-    while (it != std::cend(unselected)) {
-      std::size_t attribute_index = *it;
-      redundance.at(attribute_index) += get_mi(last_attribute_index, attribute_index);
-      double mrmr_score = mutual_informations.at(attribute_index) -
-                          redundance.at(attribute_index) / static_cast<double>(rank - 1);
+    std::size_t best_pos = 0;
+    for (std::size_t pos = 0; pos < candidates.size(); ++pos) {
+      redundance[pos] += get_mi(last_attribute_index, attributes[pos]);
+      double mrmr_score = relevance[pos] - redundance[pos] / divisor;
       if (mrmr_score - best_mrmr_score > std::numeric_limits<double>::epsilon()) {
         best_mrmr_score = mrmr_score;
-        best_attribute_index = attribute_index;
-        erase_it = last_it;
+        best_pos = pos;
       }
-      ++it;
-      ++last_it;
     }
+    std::size_t best_attribute_index = attributes[best_pos];
 
     on_selected(rank, best_attribute_index, best_mrmr_score);
 
-    unselected.erase_after(erase_it);
+    candidates.erase(best_pos);
     last_attribute_index = best_attribute_index;
     ++rank;
   }
 }
 
+/** @brief Pairwise MI strategy used by mrmr() for its selection loop. */
+enum class mrmr_mi_strategy : std::uint8_t {
+  NONE,       ///< At most one attribute is selected; no pairwise MI is needed.
+  TRIANGULAR, ///< Precompute all M*(M-1)/2 pairs into a triangular_mi_cache.
+  ON_DEMAND   ///< Compute each selected attribute's row of MI values when it is selected.
+};
+
+/**
+ * @brief Pairwise MI plan chosen by plan_mrmr() and followed by mrmr().
+ *
+ * Costs are in instance visits: pairs times N, plus a fixed per-rank charge
+ * for the on-demand path (see plan_mrmr_mi()).
+ */
+struct mrmr_plan {
+  mrmr_mi_strategy strategy = mrmr_mi_strategy::NONE;
+  std::size_t num_useful = 0;       ///< Positive-entropy attributes (M).
+  std::size_t num_selected = 0;     ///< Attributes that will be ranked (k).
+  std::size_t triangular_pairs = 0; ///< M*(M-1)/2.
+  std::size_t on_demand_pairs = 0;  ///< MI evaluations of k-1 rows over the candidates left.
+  double triangular_cost = 0;
+  double on_demand_cost = 0;
+};
+
+/**
+ * @brief Per-rank overhead of the on-demand path, in instance visits.
+ *
+ * Every rank computed on demand snapshots the candidates, hands chunks to the
+ * thread pool, and waits for the slowest chunk. That costs tens of
+ * microseconds regardless of N, about as long as the histogram loop takes to
+ * visit this many instances. It is what makes the triangle win on short
+ * datasets when k approaches M.
+ */
+constexpr std::size_t MRMR_RANK_OVERHEAD_INSTANCES = std::size_t{1} << 14;
+
+/**
+ * @brief Choose the pairwise MI strategy for a ranking of k out of M attributes.
+ *
+ * The triangular cache evaluates every pair once, M*(M-1)/2 MI computations.
+ * The on-demand path only evaluates the rows that the selection loop reads:
+ * after the r-th selection, MI between that attribute and the M - r
+ * candidates left, for r = 1 .. k-1, which is (k-1)*M - k*(k-1)/2 pairs. Each
+ * pair costs O(N) either way, so the comparison is pairs * N plus
+ * MRMR_RANK_OVERHEAD_INSTANCES per on-demand rank. For a full ranking the
+ * pair counts are equal and the triangle wins. The triangle is never chosen
+ * above @p cache_threshold, whose O(M^2) memory would not fit.
+ *
+ * @param num_useful      Number of positive-entropy candidate attributes (M).
+ * @param num_instances   Number of instances (N).
+ * @param max_features    Number of attributes to rank (0 = all).
+ * @param cache_threshold Largest M for which the triangular cache is allowed.
+ */
+inline mrmr_plan plan_mrmr_mi(std::size_t num_useful, std::size_t num_instances,
+                              std::size_t max_features, std::size_t cache_threshold) {
+  mrmr_plan plan;
+  plan.num_useful = num_useful;
+  plan.num_selected = max_features == 0 ? num_useful : std::min(num_useful, max_features);
+  if (plan.num_selected < 2) {
+    return plan;
+  }
+  std::size_t m = num_useful;
+  std::size_t k = plan.num_selected;
+  plan.triangular_pairs = m * (m - 1) / 2;
+  plan.on_demand_pairs = (k - 1) * m - k * (k - 1) / 2;
+  auto n = static_cast<double>(num_instances);
+  plan.triangular_cost = static_cast<double>(plan.triangular_pairs) * n;
+  plan.on_demand_cost =
+      static_cast<double>(plan.on_demand_pairs) * n +
+      static_cast<double>(k - 1) * static_cast<double>(MRMR_RANK_OVERHEAD_INSTANCES);
+  plan.strategy = m <= cache_threshold && plan.triangular_cost <= plan.on_demand_cost
+                      ? mrmr_mi_strategy::TRIANGULAR
+                      : mrmr_mi_strategy::ON_DEMAND;
+  return plan;
+}
+
+/**
+ * @brief The pairwise MI plan mrmr() follows for these arguments.
+ *
+ * Counts the positive-entropy attributes of @p data (entropies are cached, so
+ * this does no MI work) and applies plan_mrmr_mi(). Lets callers report or
+ * log the strategy before running the ranking.
+ */
+template <typename DataSource>
+mrmr_plan plan_mrmr(DataSource const &data, std::size_t class_attribute_index,
+                    std::size_t cache_threshold = MRMR_DEFAULT_CACHE_THRESHOLD,
+                    std::size_t max_features = 0) {
+  std::size_t num_useful = 0;
+  for (std::size_t i = 0; i < data.num_attributes(); ++i) {
+    if (i != class_attribute_index && data.attribute_entropy(i) > 0) {
+      ++num_useful;
+    }
+  }
+  return plan_mrmr_mi(num_useful, data.num_instances(), max_features, cache_threshold);
+}
+
 /**
  * @brief Compute a complete mRMR feature ranking for the given dataset.
  *
@@ -205,30 +753,55 @@ void mrmr_selection_loop(std::vector<double> const &mutual_informations,
  * score. The class attribute is emitted at rank 0. Attributes with zero entropy
  * (constant values) are ranked last with a score of -infinity.
  *
- * The MI caching strategy is selected dynamically based on the number of useful
- * (positive-entropy) attributes M:
- * - M <= @p cache_threshold: precompute all M*(M-1)/2 pairwise MI values into a
- *   triangular cache. The selection loop then performs O(1) lookups. At the
- *   default threshold of 5000 this uses approximately 95 MB.
- * - M > @p cache_threshold: compute MI on-the-fly per pair (O(N) each) using the
- *   reusable scratch buffer in dataset. Essential for very wide datasets
- *   (millions of attributes) where O(M^2) memory is infeasible.
+ * With @p max_features = k > 0 only the top k useful attributes are selected;
+ * the selection loop stops after rank k and the remaining useful attributes are
+ * not reported. Zero-entropy attributes are still appended, ranked from
+ * min(k, M) + 1, since listing them costs no MI evaluations.
+ *
+ * The MI caching strategy is chosen by plan_mrmr_mi() from the number of useful
+ * (positive-entropy) attributes M, the number of attributes to rank k, and N:
+ * - TRIANGULAR: precompute all M*(M-1)/2 pairwise MI values into a
+ *   triangular cache. The selection loop then performs O(1) lookups. Only
+ *   allowed for M <= @p cache_threshold; at the default threshold of 5000 this
+ *   uses approximately 95 MB. Chosen for full rankings.
+ * - ON_DEMAND: compute the row of the most recently selected attribute against
+ *   the remaining candidates (O(N) per pair), one batched
+ *   mutual_information_batch() call per chunk of candidates where the data
+ *   source supports it. Each row is read exactly once, so nothing is stored.
+ *   Chosen when k is small enough that the (k-1) rows are cheaper than the
+ *   triangle, and always for very wide datasets (millions of attributes)
+ *   where O(M^2) memory is infeasible. Candidates of each rank are scanned on
+ *   @p num_threads threads.
+ * Call plan_mrmr() with the same arguments to find out which one is used.
  *
  * @tparam DataSource Data source type satisfying the DataSource concept
- *                   (num_instances(), num_attributes(), attribute_name(),
+ *                   (num_instances(), num_attributes(), attribute_name()
+ *                    returning a reference to a stored std::string,
  *                    attribute_entropy(), mutual_information(), operator()).
+ * @tparam RankSink  Callable invocable as void(size_t rank, size_t index,
+ *                   std::string_view name, double entropy, double mi,
+ *                   double score), e.g. a lambda, a tsv_rank_writer, or an
+ *                   mrmr_rank_callback; called directly, without type
+ *                   erasure. std::nullptr_t disables streaming output.
  * @param data                  Data source to rank.
  * @param class_attribute_index Index of the class attribute within the data source.
- * @param on_rank               Optional callback invoked once per ranked attribute;
- *                              pass nullptr to disable streaming output.
+ * @param on_rank               Sink invoked once per ranked attribute, in rank
+ *                              order, on the calling thread; pass nullptr to
+ *                              disable streaming output.
  * @param cache_threshold       Maximum number of useful attributes for which the
  *                              triangular MI cache is precomputed.
+ * @param num_threads           Threads used to build the triangular MI cache, or to
+ *                              scan candidates on the on-the-fly path (1 = serial,
+ *                              0 = hardware concurrency). The ranking does not
+ *                              depend on the thread count.
+ * @param max_features          Number of useful attributes to select (0 = all).
  * @return mrmr_return_type containing six parallel vectors of per-rank metadata.
  */
-template <typename DataSource>
+template <typename DataSource, typename RankSink = std::nullptr_t>
 mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
-                      mrmr_rank_callback const &on_rank = nullptr,
-                      std::size_t cache_threshold = MRMR_DEFAULT_CACHE_THRESHOLD) {
+                      RankSink &&on_rank = nullptr,
+                      std::size_t cache_threshold = MRMR_DEFAULT_CACHE_THRESHOLD,
+                      std::size_t num_threads = 1, std::size_t max_features = 0) {
 
   mrmr_return_type retval;
   std::get<0>(retval).reserve(data.num_attributes());
@@ -238,8 +811,9 @@ mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
   std::get<4>(retval).reserve(data.num_attributes());
   std::get<5>(retval).reserve(data.num_attributes());
 
-  // Helper to record a rank and optionally invoke the callback
-  auto emit_rank = [&](std::size_t rank, std::size_t index, std::string const &name, double entropy,
+  // Helper to record a rank and optionally invoke the sink
+  bool const stream_ranks = detail::is_active_rank_sink(on_rank);
+  auto emit_rank = [&](std::size_t rank, std::size_t index, std::string_view name, double entropy,
                        double mi, double score) {
     std::get<0>(retval).push_back(rank);
     std::get<1>(retval).push_back(index);
@@ -247,22 +821,21 @@ mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
     std::get<3>(retval).push_back(entropy);
     std::get<4>(retval).push_back(mi);
     std::get<5>(retval).push_back(score);
-    if (on_rank) {
-      on_rank(rank, index, name, entropy, mi, score);
+    if constexpr (!std::is_null_pointer_v<std::remove_cvref_t<RankSink>>) {
+      if (stream_ranks) {
+        on_rank(rank, index, name, entropy, mi, score);
+      }
     }
   };
 
   // Compute mRMR prerequisites: MI with class for all positive-entropy attributes
   std::vector<double> mutual_informations(data.num_attributes());
-  std::vector<double> redundance(data.num_attributes(), 0.0);
-  std::forward_list<std::size_t> unselected;
   std::vector<std::size_t> useless;
   std::vector<std::size_t> useful_indices;
   for (std::size_t i = 0; i < data.num_attributes(); ++i) {
     if (i != class_attribute_index) {
       if (data.attribute_entropy(i) > 0) {
         mutual_informations[i] = data.mutual_information(class_attribute_index, i);
-        unselected.push_front(i);
         useful_indices.push_back(i);
       } else {
         mutual_informations[i] = 0;
@@ -270,8 +843,10 @@ mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
       }
     }
   }
-  unselected.reverse();
   mutual_informations[class_attribute_index] = -std::numeric_limits<double>::infinity();
+  mrmr_plan plan =
+      plan_mrmr_mi(useful_indices.size(), data.num_instances(), max_features, cache_threshold);
+  std::size_t num_selected = plan.num_selected;
 
   // Emit class attribute information (rank 0)
   double class_entropy = data.attribute_entropy(class_attribute_index);
@@ -296,7 +871,13 @@ mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
       }
     }
     std::size_t last_attribute_index = best_attribute_index;
-    unselected.remove(best_attribute_index);
+    mrmr_candidates candidates;
+    candidates.reserve(useful_indices.size() - 1);
+    for (std::size_t idx : useful_indices) {
+      if (idx != best_attribute_index) {
+        candidates.push_back(idx, mutual_informations[idx]);
+      }
+    }
     double mrmr_score = mutual_informations.at(best_attribute_index);
 
     emit_rank(1, best_attribute_index, data.attribute_name(best_attribute_index),
@@ -308,25 +889,24 @@ mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
                 mutual_informations.at(attr_index), score);
     };
 
-    // Choose MI lookup strategy based on number of useful attributes.
-    // For moderate M: precompute all pairwise MI into triangular cache (O(1) lookup).
-    // For very large M: compute on-the-fly to avoid O(M^2) memory (O(N) per lookup).
-    if (useful_indices.size() <= cache_threshold && useful_indices.size() > 1) {
-      triangular_mi_cache<DataSource> cache(data, useful_indices);
-      mrmr_selection_loop(
-          mutual_informations, redundance, unselected, last_attribute_index, 2,
-          [&cache](std::size_t a1, std::size_t a2) { return cache.get(a1, a2); }, on_selected);
-    } else if (useful_indices.size() > 1) {
+    // Follow the plan: the full triangle with O(1) lookups, or one row of MI
+    // per selection computed on demand.
+    if (plan.strategy == mrmr_mi_strategy::TRIANGULAR) {
+      triangular_mi_cache<DataSource> cache(data, useful_indices, num_threads);
       mrmr_selection_loop(
-          mutual_informations, redundance, unselected, last_attribute_index, 2,
-          [&data](std::size_t a1, std::size_t a2) { return data.mutual_information(a1, a2); },
-          on_selected);
+          candidates, last_attribute_index, 2,
+          [&cache](std::size_t a1, std::size_t a2) { return cache.get(a1, a2); }, on_selected, 1,
+          num_selected);
+    } else if (plan.strategy == mrmr_mi_strategy::ON_DEMAND) {
+      mrmr_selection_loop(candidates, last_attribute_index, 2,
+                          detail::on_the_fly_mi<DataSource>(data), on_selected, num_threads,
+                          num_selected);
     }
   }
 
   // Append useless features (zero-entropy attributes).
-  // Useful attributes occupy ranks 1 through useful_indices.size(); useless follow.
-  std::size_t useless_rank = useful_indices.size() + 1;
+  // Selected attributes occupy ranks 1 through num_selected; useless follow.
+  std::size_t useless_rank = num_selected + 1;
   std::ranges::sort(useless);
   for (auto attribute_index : useless) {
     emit_rank(useless_rank++, attribute_index, data.attribute_name(attribute_index), 0, 0,
@@ -336,4 +916,20 @@ mrmr_return_type mrmr(DataSource const &data, std::size_t class_attribute_index,
   return retval;
 }
 
+/**
+ * @brief Ranking a temporary owning data source is rejected at compile time.
+ *
+ * The names in mrmr_return_type view the data source's stored names, which a
+ * temporary dataset, continuous_dataset, or mixed_dataset destroys at the end
+ * of the call's full expression. Keep the data source in a variable. A
+ * temporary dataset_view is accepted, since its names belong to the parent.
+ */
+template <typename T, typename... Args>
+mrmr_return_type mrmr(dataset<T> &&data, Args &&...args) = delete;
+/** @copydoc mrmr(dataset<T> &&, Args &&...) */
+template <typename FloatT, typename... Args>
+mrmr_return_type mrmr(continuous_dataset<FloatT> &&data, Args &&...args) = delete;
+/** @copydoc mrmr(dataset<T> &&, Args &&...) */
+template <typename... Args> mrmr_return_type mrmr(mixed_dataset &&data, Args &&...args) = delete;
+
 #endif
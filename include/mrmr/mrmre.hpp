@@ -5,6 +5,8 @@
 #define MRMR_MRMRE_HPP
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -17,8 +19,11 @@
 #endif
 #include <numeric>
 #include <random>
+#include <span>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 /**
@@ -192,6 +197,287 @@ inline mixed_dataset bootstrap_resample(mixed_dataset const &source, std::mt1993
 }
 #endif
 
+namespace detail {
+
+/**
+ * @brief Split a thread budget between independent ensemble solutions.
+ *
+ * Solutions are the coarsest unit of work, so they get as many threads as
+ * there are solutions; threads left over are handed to each solution's own
+ * cache build or candidate scan.
+ *
+ * @param num_threads   Thread budget (0 = hardware concurrency).
+ * @param num_solutions Number of solutions to compute.
+ * @return {threads across solutions, threads within each solution}, both >= 1.
+ */
+inline std::pair<std::size_t, std::size_t> split_ensemble_threads(std::size_t num_threads,
+                                                                  std::size_t num_solutions) {
+  std::size_t total = resolve_thread_count(num_threads);
+  std::size_t outer = std::clamp<std::size_t>(num_solutions, 1, total);
+  return {outer, std::max<std::size_t>(1, total / outer)};
+}
+
+/**
+ * @brief Random number generator of bootstrap solution @p solution.
+ *
+ * Each solution draws from its own stream, seeded from (@p seed, @p solution),
+ * so a solution's resample does not depend on which thread builds it or on
+ * how many solutions were built before it.
+ */
+inline std::mt19937 bootstrap_generator(unsigned seed, std::size_t solution) {
+  std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(solution),
+                    static_cast<std::uint32_t>(static_cast<std::uint64_t>(solution) >> 32)};
+  return std::mt19937(seq);
+}
+
+/// Default bound, in bytes, on the per-solution state of exhaustive_lockstep.
+inline constexpr std::size_t lockstep_state_bytes = std::size_t{64} << 20;
+
+/**
+ * @brief Run the selection loops of all EXHAUSTIVE solutions in lockstep.
+ *
+ * Solution s is seeded with the s-th most relevant attribute and then
+ * selects, rank by rank, exactly what mrmr_selection_loop would select from
+ * the other attributes in relevance order. Instead of running one loop per
+ * solution, a batch of solutions advances one rank at a time over shared
+ * state:
+ * - Attribute indices and relevance are stored once, by position in
+ *   @p mi_ranked; each solution keeps only its redundance (one row of a
+ *   solution-by-position array) and the ordered positions it has not
+ *   selected yet.
+ * - At each rank, solutions are grouped by the attribute they selected last.
+ *   A single solution's MI row is fetched over its own candidates; a larger
+ *   group's row is fetched once, over the union of its members' candidates,
+ *   and every member updates its redundance from that row. Solutions tend to
+ *   converge on the same attributes, so later ranks read each row once
+ *   instead of once per solution.
+ *
+ * Each solution in a batch holds at most four words per position (candidates,
+ * redundance, and its share of the fetched rows and their positions), so
+ * batches are sized to keep that state within @p state_bytes, plus O(M)
+ * shared state for M = mi_ranked.size(). A batch holds at least one solution.
+ *
+ * Redundance is accumulated and scored in the same order, with the same
+ * epsilon rule, as mrmr_selection_loop, so solutions are identical to
+ * independent loops and do not depend on the batch size. With
+ * @p num_threads != 1 the row fetches are split into chunks, and the solution
+ * updates into solutions, over a thread pool.
+ *
+ * @tparam MILookup     Callable as double(size_t, size_t), optionally also as
+ *                      void(size_t, span<size_t const>, span<double>) (see
+ *                      mrmr_selection_loop). Must be safe for concurrent calls
+ *                      with different fixed attributes or disjoint partners
+ *                      when @p num_threads != 1.
+ * @param mi_ranked     (MI with class, attribute index) of every candidate, in
+ *                      scan order.
+ * @param num_solutions Number of solutions (at most mi_ranked.size()).
+ * @param feature_count Attributes to select per solution, seed included.
+ * @param get_mi        MI lookup.
+ * @param num_threads   Threads used per rank (1 = serial, 0 = hardware concurrency).
+ * @param state_bytes   Bound on the per-solution state of one batch.
+ * @return One solution per seed, in seed order.
+ */
+template <typename MILookup>
+std::vector<mrmre_solution>
+exhaustive_lockstep(std::vector<std::pair<double, std::size_t>> const &mi_ranked,
+                    std::size_t num_solutions, std::size_t feature_count, MILookup &get_mi,
+                    std::size_t num_threads = 1, std::size_t state_bytes = lockstep_state_bytes) {
+  constexpr bool batched = std::is_invocable_v<MILookup &, std::size_t,
+                                               std::span<std::size_t const>, std::span<double>>;
+  constexpr std::size_t no_group = std::numeric_limits<std::size_t>::max();
+  std::size_t num_positions = mi_ranked.size();
+  assert(num_solutions <= num_positions);
+
+  std::vector<std::size_t> attributes(num_positions);
+  std::vector<double> relevance(num_positions);
+  for (std::size_t p = 0; p < num_positions; ++p) {
+    relevance[p] = mi_ranked[p].first;
+    attributes[p] = mi_ranked[p].second;
+  }
+
+  std::vector<mrmre_solution> solutions(num_solutions);
+  std::size_t last_rank = std::min(feature_count, num_positions);
+  for (std::size_t s = 0; s < num_solutions; ++s) {
+    solutions[s].selected_indices.reserve(std::max<std::size_t>(last_rank, 1));
+    solutions[s].scores.reserve(std::max<std::size_t>(last_rank, 1));
+    solutions[s].selected_indices.push_back(attributes[s]);
+    solutions[s].scores.push_back(relevance[s]);
+  }
+  if (last_rank < 2) {
+    return solutions;
+  }
+
+  std::size_t batch_size = std::clamp<std::size_t>(
+      state_bytes / (4 * sizeof(std::size_t) * num_positions), 1, num_solutions);
+  std::vector<std::vector<std::size_t>> active(batch_size); // unselected positions, in order
+  std::vector<std::size_t> last(batch_size);                // last selected position
+  std::vector<double> redundance;
+  std::vector<std::size_t> group_of_position(num_positions, no_group);
+  std::vector<std::size_t> group_position; // last selected position shared by each group
+  std::vector<std::size_t> group_of_solution(batch_size);
+  std::vector<std::size_t> member_offset; // members of group g at [member_offset[g], [g + 1])
+  std::vector<std::size_t> members(batch_size);
+  // Candidate positions of group g: a single member's own list, or the union
+  // of its members' lists at union_positions[union_offset[g]]; MI values at
+  // row_values[value_offset[g]].
+  std::vector<std::size_t const *> group_positions;
+  std::vector<std::size_t> group_size;
+  std::vector<std::size_t> union_offset;
+  std::vector<std::size_t> union_positions;
+  std::vector<std::size_t> value_offset;
+  std::vector<double> row_values;
+  std::vector<std::size_t> union_stamp(num_positions, 0); // last union each position joined
+  std::size_t stamp = 0;
+  std::vector<std::array<std::size_t, 3>> fetches; // {group, begin, end} within the row
+  detail::thread_pool pool(num_threads);
+
+  for (std::size_t first = 0; first < num_solutions; first += batch_size) {
+    std::size_t count = std::min(batch_size, num_solutions - first);
+    for (std::size_t b = 0; b < count; ++b) {
+      last[b] = first + b;
+      active[b].clear();
+      active[b].reserve(num_positions - 1);
+      for (std::size_t p = 0; p < num_positions; ++p) {
+        if (p != first + b) {
+          active[b].push_back(p);
+        }
+      }
+    }
+    redundance.assign(count * num_positions, 0.0);
+
+    for (std::size_t rank = 2; rank <= last_rank; ++rank) {
+      group_position.clear();
+      for (std::size_t b = 0; b < count; ++b) {
+        std::size_t &group = group_of_position[last[b]];
+        if (group == no_group) {
+          group = group_position.size();
+          group_position.push_back(last[b]);
+        }
+        group_of_solution[b] = group;
+      }
+      std::size_t num_groups = group_position.size();
+
+      // Members of each group, in solution order (counting sort).
+      member_offset.assign(num_groups + 1, 0);
+      for (std::size_t b = 0; b < count; ++b) {
+        ++member_offset[group_of_solution[b] + 1];
+      }
+      for (std::size_t g = 0; g < num_groups; ++g) {
+        member_offset[g + 1] += member_offset[g];
+      }
+      for (std::size_t b = 0; b < count; ++b) {
+        members[member_offset[group_of_solution[b]]++] = b;
+      }
+      std::rotate(member_offset.begin(), member_offset.end() - 1, member_offset.end());
+      member_offset[0] = 0;
+
+      // Candidate rows: a single member's list is used in place; larger
+      // groups merge their members' sorted lists.
+      group_size.assign(num_groups, 0);
+      union_offset.assign(num_groups, 0);
+      value_offset.assign(num_groups + 1, 0);
+      union_positions.clear();
+      for (std::size_t g = 0; g < num_groups; ++g) {
+        if (member_offset[g + 1] - member_offset[g] == 1) {
+          group_size[g] = active[members[member_offset[g]]].size();
+        } else {
+          ++stamp;
+          union_offset[g] = union_positions.size();
+          for (std::size_t m = member_offset[g]; m < member_offset[g + 1]; ++m) {
+            for (std::size_t p : active[members[m]]) {
+              if (union_stamp[p] != stamp) {
+                union_stamp[p] = stamp;
+                union_positions.push_back(p);
+              }
+            }
+          }
+          auto union_begin = union_positions.begin() + static_cast<std::ptrdiff_t>(union_offset[g]);
+          std::sort(union_begin, union_positions.end());
+          group_size[g] = union_positions.size() - union_offset[g];
+        }
+        value_offset[g + 1] = value_offset[g] + group_size[g];
+      }
+      group_positions.resize(num_groups);
+      for (std::size_t g = 0; g < num_groups; ++g) {
+        group_positions[g] = member_offset[g + 1] - member_offset[g] == 1
+                                 ? active[members[member_offset[g]]].data()
+                                 : union_positions.data() + union_offset[g];
+      }
+      row_values.resize(value_offset[num_groups]);
+
+      // Fetch the rows in chunks of roughly four per thread, but never fewer
+      // partners than one full MI batch.
+      std::size_t grain =
+          std::max<std::size_t>(mi_batch_width, row_values.size() / (4 * pool.size()));
+      fetches.clear();
+      for (std::size_t g = 0; g < num_groups; ++g) {
+        for (std::size_t begin = 0; begin < group_size[g]; begin += grain) {
+          fetches.push_back({g, begin, std::min(begin + grain, group_size[g])});
+        }
+      }
+      pool.parallel_for(fetches.size(), 1, [&](std::size_t task_begin, std::size_t task_end) {
+        std::vector<std::size_t> partners;
+        for (std::size_t t = task_begin; t < task_end; ++t) {
+          auto [g, begin, end] = fetches[t];
+          std::size_t fixed = attributes[group_position[g]];
+          double *values = row_values.data() + value_offset[g];
+          if constexpr (batched) {
+            partners.resize(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+              partners[i - begin] = attributes[group_positions[g][i]];
+            }
+            get_mi(fixed, std::span<std::size_t const>(partners),
+                   std::span<double>(values + begin, end - begin));
+          } else {
+            for (std::size_t i = begin; i < end; ++i) {
+              values[i] = get_mi(fixed, attributes[group_positions[g][i]]);
+            }
+          }
+        }
+      });
+
+      auto divisor = static_cast<double>(rank - 1);
+      pool.parallel_for(count, 1, [&](std::size_t sol_begin, std::size_t sol_end) {
+        for (std::size_t b = sol_begin; b < sol_end; ++b) {
+          std::size_t g = group_of_solution[b];
+          // The solution's candidates are a sorted subset of its group's row.
+          std::size_t const *row_pos = group_positions[g];
+          double const *row_mi = row_values.data() + value_offset[g];
+          double *red = redundance.data() + b * num_positions;
+          std::vector<std::size_t> &candidates = active[b];
+          double best_mrmr_score = -std::numeric_limits<double>::infinity();
+          std::size_t best_i = 0;
+          std::size_t j = 0;
+          for (std::size_t i = 0; i < candidates.size(); ++i) {
+            std::size_t p = candidates[i];
+            while (row_pos[j] != p) {
+              ++j;
+            }
+            red[p] += row_mi[j];
+            double mrmr_score = relevance[p] - red[p] / divisor;
+            if (mrmr_score - best_mrmr_score > std::numeric_limits<double>::epsilon()) {
+              best_mrmr_score = mrmr_score;
+              best_i = i;
+            }
+          }
+          last[b] = candidates[best_i];
+          solutions[first + b].selected_indices.push_back(attributes[last[b]]);
+          solutions[first + b].scores.push_back(best_mrmr_score);
+          // A row used in place is this solution's own list, read by no other.
+          candidates.erase(candidates.begin() + static_cast<std::ptrdiff_t>(best_i));
+        }
+      });
+
+      for (std::size_t p : group_position) {
+        group_of_position[p] = no_group;
+      }
+    }
+  }
+  return solutions;
+}
+
+} // namespace detail
+
 /**
  * @brief Perform mRMRe ensemble feature selection.
  *
@@ -199,6 +485,15 @@ inline mixed_dataset bootstrap_resample(mixed_dataset const &source, std::mt1993
  * or mixed_dataset. Bootstrap resampling dispatches to the appropriate
  * overload of bootstrap_resample().
  *
+ * EXHAUSTIVE solutions advance in lockstep (see detail::exhaustive_lockstep):
+ * each rank fetches the MI row of every distinct last-selected attribute once
+ * for all solutions that need it, from one MI cache shared by all solutions.
+ * BOOTSTRAP solutions are independent and are computed in parallel on up to
+ * @p num_threads threads (see detail::split_ensemble_threads), each resampling
+ * with its own generator derived from @p seed (see detail::bootstrap_generator).
+ * Every solution is stored at its own index, so solutions and consensus do not
+ * depend on the thread count.
+ *
  * @tparam DataSource Data source type satisfying the DataSource concept.
  * @param data                  Source data.
  * @param class_attribute_index Index of the class/target attribute.
@@ -207,13 +502,21 @@ inline mixed_dataset bootstrap_resample(mixed_dataset const &source, std::mt1993
  * @param method                Ensemble method (EXHAUSTIVE or BOOTSTRAP).
  * @param seed                  Random seed for bootstrap resampling.
  * @param cache_threshold       MI cache threshold passed to underlying mRMR calls.
+ * @param num_threads           Threads used to compute solutions, build MI caches,
+ *                              and scan candidates on the on-the-fly path
+ *                              (1 = serial, 0 = hardware concurrency).
+ * @param lazy_cache_bytes      EXHAUSTIVE with more useful attributes than
+ *                              @p cache_threshold: byte budget of the lazy_mi_cache
+ *                              shared by all solutions (0 disables it).
  * @return mrmre_result with all solutions and consensus ranking.
  */
 template <typename DataSource>
 mrmre_result mrmre(DataSource const &data, std::size_t class_attribute_index,
                    std::size_t feature_count, std::size_t solution_count,
                    mrmre_method method = mrmre_method::EXHAUSTIVE, unsigned seed = 42,
-                   std::size_t cache_threshold = MRMR_DEFAULT_CACHE_THRESHOLD) {
+                   std::size_t cache_threshold = MRMR_DEFAULT_CACHE_THRESHOLD,
+                   std::size_t num_threads = 1,
+                   std::size_t lazy_cache_bytes = MRMR_DEFAULT_LAZY_CACHE_BYTES) {
   mrmre_result result;
 
   if (method == mrmre_method::EXHAUSTIVE) {
@@ -230,19 +533,8 @@ mrmre_result mrmre(DataSource const &data, std::size_t class_attribute_index,
 
     // Generate one solution per top-k seed feature, each forced to start
     // with a different feature. We precompute class-MI for all useful attrs,
-    // then for each seed, force it as rank-1 and run the selection loop.
+    // then force each seed as rank-1 and run the selection loops together.
     std::size_t num_solutions = std::min(solution_count, mi_ranked.size());
-    result.solutions.reserve(num_solutions);
-
-    // Precompute class-MI vector (shared across all exhaustive solutions)
-    std::vector<double> mutual_informations(data.num_attributes(), 0.0);
-    std::forward_list<std::size_t> all_useful;
-    for (auto const &pair : mi_ranked) {
-      mutual_informations[pair.second] = pair.first;
-      all_useful.push_front(pair.second);
-    }
-    all_useful.reverse();
-    mutual_informations[class_attribute_index] = -std::numeric_limits<double>::infinity();
 
     // Build useful_indices for potential triangular cache
     std::vector<std::size_t> useful_indices;
@@ -251,53 +543,41 @@ mrmre_result mrmre(DataSource const &data, std::size_t class_attribute_index,
       useful_indices.push_back(pair.second);
     }
 
-    // MI lookup: use triangular cache when M is manageable, on-the-fly otherwise
-    auto run_exhaustive = [&](auto &&get_mi) {
-      for (std::size_t s = 0; s < num_solutions; ++s) {
-        std::size_t seed_attr = mi_ranked[s].second;
-
-        mrmre_solution sol;
-        sol.selected_indices.push_back(seed_attr);
-        sol.scores.push_back(mutual_informations[seed_attr]);
-
-        if (feature_count > 1 && mi_ranked.size() > 1) {
-          std::forward_list<std::size_t> unselected = all_useful;
-          unselected.remove(seed_attr);
-          std::vector<double> redundance(data.num_attributes(), 0.0);
-
-          mrmr_selection_loop(
-              mutual_informations, redundance, unselected, seed_attr, 2, get_mi,
-              [&sol, feature_count](std::size_t /*rank*/, std::size_t attr_index, double score) {
-                if (sol.selected_indices.size() < feature_count) {
-                  sol.selected_indices.push_back(attr_index);
-                  sol.scores.push_back(score);
-                }
-              });
-        }
-
-        result.solutions.push_back(std::move(sol));
-      }
-    };
-
+    // MI lookup: use triangular cache when M is manageable; otherwise a lazy
+    // row cache, since solutions share most of their selected attributes and
+    // therefore most of the rows they read.
     if (useful_indices.size() <= cache_threshold && useful_indices.size() > 1) {
-      triangular_mi_cache<DataSource> cache(data, useful_indices);
-      run_exhaustive([&cache](std::size_t a1, std::size_t a2) { return cache.get(a1, a2); });
+      triangular_mi_cache<DataSource> cache(data, useful_indices, num_threads);
+      auto get_mi = [&cache](std::size_t a1, std::size_t a2) { return cache.get(a1, a2); };
+      result.solutions = detail::exhaustive_lockstep(mi_ranked, num_solutions, feature_count,
+                                                     get_mi, num_threads);
     } else {
-      run_exhaustive(
-          [&data](std::size_t a1, std::size_t a2) { return data.mutual_information(a1, a2); });
+      lazy_mi_cache<DataSource> lazy(data, useful_indices, lazy_cache_bytes);
+      result.solutions = detail::exhaustive_lockstep(mi_ranked, num_solutions, feature_count,
+                                                     lazy, num_threads);
     }
 
   } else if (method == mrmre_method::BOOTSTRAP) {
-    std::seed_seq seq{seed};
-    std::mt19937 gen(seq);
-    result.solutions.reserve(solution_count);
+    result.solutions.resize(solution_count);
+    auto [solution_threads, loop_threads] =
+        detail::split_ensemble_threads(num_threads, solution_count);
 
-    for (std::size_t s = 0; s < solution_count; ++s) {
+    auto solve = [&](std::size_t s) {
       // Create bootstrap sample — dispatches to optimal strategy per DataSource
+      std::mt19937 gen = detail::bootstrap_generator(seed, s);
       auto sample = bootstrap_resample(data, gen);
-      auto mrmr_result = mrmr(sample, class_attribute_index, nullptr, cache_threshold);
-      result.solutions.push_back(extract_solution(mrmr_result, feature_count));
-    }
+      // Only the top feature_count useful attributes are kept, so the ranking
+      // stops there (O(k * M) MI evaluations instead of O(M^2)).
+      auto mrmr_result = mrmr(sample, class_attribute_index, nullptr, cache_threshold,
+                              loop_threads, feature_count);
+      result.solutions[s] = extract_solution(mrmr_result, feature_count);
+    };
+    detail::parallel_for(solution_threads, solution_count, 1,
+                         [&](std::size_t begin, std::size_t end) {
+                           for (std::size_t s = begin; s < end; ++s) {
+                             solve(s);
+                           }
+                         });
   }
 
   // Build consensus ranking
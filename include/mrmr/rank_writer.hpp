@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (C) 2018-2026 Ryan N. Lichtenwalter
+
+#ifndef MRMR_RANK_WRITER_HPP
+#define MRMR_RANK_WRITER_HPP
+
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Buffered tab-separated writer for mRMR ranks, usable as the rank sink of mrmr().
+ *
+ * Each call appends one line "rank, index, name, [entropy,] mi, score" to an
+ * in-memory buffer, formatting the numbers with std::to_chars; the buffer is
+ * written to the stream whenever it fills, on flush(), and on destruction.
+ * Doubles are formatted like printf with the given std::chars_format and
+ * precision, which is how an std::ostream prints them: the defaults
+ * (general, 6) match a stream with default flags, and scientific or fixed
+ * with precision p match std::scientific or std::fixed with
+ * std::setprecision(p). The output is byte-identical to streaming the values
+ * with operator<< under those flags.
+ *
+ * Non-copyable; pass it to mrmr() by reference.
+ */
+class tsv_rank_writer {
+public:
+  /// Default buffer size in bytes.
+  static constexpr std::size_t default_buffer_size = std::size_t{1} << 16;
+
+  /// Smallest buffer used; holds any number this writer formats (a double in
+  /// fixed format has at most 309 integer digits).
+  static constexpr std::size_t min_buffer_size = 512;
+
+  /**
+   * @param os            Output stream (must outlive the writer).
+   * @param write_entropy Whether lines include the entropy column.
+   * @param format        Floating-point format of the entropy, MI, and score.
+   * @param precision     Digits, as for std::setprecision (at most 100).
+   * @param buffer_size   Bytes buffered between writes to @p os (at least
+   *                      min_buffer_size are used).
+   */
+  explicit tsv_rank_writer(std::ostream &os, bool write_entropy = true,
+                           std::chars_format format = std::chars_format::general,
+                           int precision = 6, std::size_t buffer_size = default_buffer_size)
+      : _os(os), _write_entropy(write_entropy), _format(format), _precision(precision),
+        _buffer(buffer_size < min_buffer_size ? min_buffer_size : buffer_size) {
+    assert(precision >= 0 && precision <= 100);
+  }
+
+  tsv_rank_writer(tsv_rank_writer const &) = delete;
+  tsv_rank_writer &operator=(tsv_rank_writer const &) = delete;
+
+  ~tsv_rank_writer() { flush(); }
+
+  /** @brief Append the line of one ranked attribute. */
+  void operator()(std::size_t rank, std::size_t index, std::string_view name, double entropy,
+                  double mi, double score) {
+    append_number(rank);
+    append('\t');
+    append_number(index);
+    append('\t');
+    append(name);
+    append('\t');
+    if (_write_entropy) {
+      append_number(entropy);
+      append('\t');
+    }
+    append_number(mi);
+    append('\t');
+    append_number(score);
+    append('\n');
+  }
+
+  /** @brief Write the buffered lines to the stream and flush it. */
+  void flush() {
+    if (_used > 0) {
+      _os.write(_buffer.data(), static_cast<std::streamsize>(_used));
+      _used = 0;
+    }
+    _os.flush();
+  }
+
+private:
+  void drain() {
+    _os.write(_buffer.data(), static_cast<std::streamsize>(_used));
+    _used = 0;
+  }
+
+  void append(char c) {
+    if (_used == _buffer.size()) {
+      drain();
+    }
+    _buffer[_used++] = c;
+  }
+
+  void append(std::string_view text) {
+    if (text.size() > _buffer.size() - _used) {
+      drain();
+      if (text.size() > _buffer.size()) {
+        _os.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+      }
+    }
+    text.copy(_buffer.data() + _used, text.size());
+    _used += text.size();
+  }
+
+  // Formats into the free end of the buffer; if the number does not fit,
+  // drains the buffer and formats again at its start.
+  template <typename Number> void append_number(Number value) {
+    auto format_at = [&](std::size_t offset) {
+      char *first = _buffer.data() + offset;
+      char *last = _buffer.data() + _buffer.size();
+      if constexpr (std::is_floating_point_v<Number>) {
+        return std::to_chars(first, last, value, _format, _precision);
+      } else {
+        return std::to_chars(first, last, value);
+      }
+    };
+    auto result = format_at(_used);
+    if (result.ec != std::errc{}) {
+      drain();
+      result = format_at(0);
+      assert(result.ec == std::errc{});
+    }
+    _used = static_cast<std::size_t>(result.ptr - _buffer.data());
+  }
+
+  std::ostream &_os;
+  bool _write_entropy;
+  std::chars_format _format;
+  int _precision;
+  std::vector<char> _buffer;
+  std::size_t _used = 0;
+};
+
+#endif
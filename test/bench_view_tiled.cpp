@@ -10,6 +10,7 @@ Tests:
 3. Both materialized — after tiled gather
 4. Tiled block computation — amortized gather over B*(B-1)/2 pairs
 5. End-to-end triangular cache construction comparison
+6. Library triangular_mi_cache on a resampled index view: per-pair vs instance-blocked tiles
 */
 
 #include <algorithm>
@@ -23,6 +24,9 @@ Tests:
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <mrmr/dataset_view.hpp>
+#include <mrmr/mrmr.hpp>
+
 // Simulate MI histogram building with different access patterns.
 // Uses raw arrays to isolate access pattern cost from dataset overhead.
 
@@ -296,3 +300,50 @@ TEST_CASE("bench: on-the-fly path strategies, N=100K", "[!benchmark][tiled]") {
     });
   };
 }
+
+// ============================================================================
+// Library engine: triangular_mi_cache on a resampled index view
+// ============================================================================
+
+TEST_CASE("bench: library tiled cache vs per-pair on index view, M=96, N=100K",
+          "[!benchmark][tiled]") {
+  std::size_t n = 100000;
+  std::size_t m = 96;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 3);
+  std::vector<unsigned char> data(n * m);
+  for (auto &v : data) {
+    v = static_cast<unsigned char>(dist(gen));
+  }
+  dataset<unsigned char> ds(data, n, m);
+  // N draws with replacement, listed explicitly so MI goes through the
+  // view's sorted indirection (bootstrap() would give a count-weighted view).
+  std::vector<std::size_t> sample(n);
+  for (auto &inst : sample) {
+    inst = std::uniform_int_distribution<std::size_t>(0, n - 1)(gen);
+  }
+  dataset_view<unsigned char> view(ds, sample);
+  std::vector<std::size_t> indices(m);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  BENCHMARK_ADVANCED("per-pair mutual_information (sorted indirection)")
+  (Catch::Benchmark::Chronometer meter) {
+    meter.measure([&] {
+      double total = 0;
+      for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = i + 1; j < m; ++j) {
+          total += view.mutual_information(i, j);
+        }
+      }
+      return total;
+    });
+  };
+
+  BENCHMARK_ADVANCED("triangular_mi_cache (instance-blocked tiles)")
+  (Catch::Benchmark::Chronometer meter) {
+    meter.measure([&] {
+      triangular_mi_cache<dataset_view<unsigned char>> cache(view, indices);
+      return cache.get(0, 1);
+    });
+  };
+}
@@ -4,8 +4,17 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
@@ -21,6 +30,43 @@
 #include <mrmr/mixed_dataset.hpp>
 #endif
 #include <mrmr/mrmre.hpp>
+#include <mrmr/rank_writer.hpp>
+
+namespace {
+
+/**
+ * Row-major random values for an @p n x @p m dataset; attribute `a` is drawn
+ * uniformly from [0, cardinality(a)). @p cardinality is either a count shared
+ * by every attribute or a callable taking the attribute index.
+ */
+template <class Cardinality>
+std::vector<unsigned char> random_values(std::size_t n, std::size_t m, unsigned seed,
+                                         Cardinality cardinality) {
+  std::mt19937 gen(seed);
+  std::vector<unsigned char> data(n * m);
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    for (std::size_t attr = 0; attr < m; ++attr) {
+      int card;
+      if constexpr (std::is_invocable_v<Cardinality, std::size_t>) {
+        card = static_cast<int>(cardinality(attr));
+      } else {
+        card = static_cast<int>(cardinality);
+      }
+      data[inst * m + attr] =
+          static_cast<unsigned char>(std::uniform_int_distribution<int>(0, card - 1)(gen));
+    }
+  }
+  return data;
+}
+
+/** Dataset over random_values(n, m, seed, cardinality). */
+template <class Cardinality>
+dataset<unsigned char> random_dataset(std::size_t n, std::size_t m, unsigned seed,
+                                      Cardinality cardinality) {
+  return dataset<unsigned char>(random_values(n, m, seed, cardinality), n, m);
+}
+
+} // namespace
 
 // ============================================================================
 // attribute_information tests
@@ -49,6 +95,59 @@ TEST_CASE("attribute_information marginal_probability", "[attribute_information]
   REQUIRE(ai.marginal_probability(2) == 4.0 / 16.0);
 }
 
+TEST_CASE("attribute_information_builder matches the range constructor",
+          "[attribute_information]") {
+  std::array<unsigned char, 16> a = {0, 0, 0, 1, 1, 1, 0, 2, 2, 2, 1, 1, 0, 1, 1, 2};
+  attribute_information<unsigned char> expected(std::cbegin(a), std::cend(a));
+  // The same multiset, streamed in another order and partly with multiplicities.
+  attribute_information_builder<unsigned char> builder;
+  builder.add(2, 4);
+  builder.add(1, 6);
+  builder.add(1);
+  for (int i = 0; i < 5; ++i) {
+    builder.add(0);
+  }
+  REQUIRE(builder.size() == a.size());
+  auto built = builder.build();
+  REQUIRE(built.num_values() == expected.num_values());
+  REQUIRE(built.entropy() == expected.entropy());
+  for (unsigned char v = 0; v < 3; ++v) {
+    REQUIRE(built.marginal_probability(v) == expected.marginal_probability(v));
+  }
+
+  std::vector<std::uint16_t> dense = {0, 3, 1, 3, 1, 2, 3, 1};
+  attribute_information<std::uint16_t> wide_expected(dense.begin(), dense.end());
+  attribute_information_builder<std::uint16_t> wide_builder;
+  for (auto v : dense) {
+    wide_builder.add(v);
+  }
+  REQUIRE(wide_builder.build().entropy() == wide_expected.entropy());
+  REQUIRE(wide_builder.build().num_values() == 4);
+  REQUIRE(attribute_information_builder<std::uint16_t>().size() == 0);
+}
+
+TEST_CASE("stream_attribute_information matches per-attribute construction",
+          "[attribute_information]") {
+  std::size_t n = 300;
+  std::size_t m = 9;
+  auto ds = random_dataset(n, m, 41, [](std::size_t attr) { return attr + 2; });
+
+  for (std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+    auto infos = stream_attribute_information(ds, threads);
+    auto doubled = stream_attribute_information(ds, threads,
+                                                [](std::size_t) -> std::size_t { return 2; });
+    REQUIRE(infos.size() == m);
+    for (std::size_t attr = 0; attr < m; ++attr) {
+      unsigned char const *column = ds.column_data(attr);
+      attribute_information<unsigned char> expected(column, column + n);
+      REQUIRE(infos[attr].entropy() == expected.entropy());
+      REQUIRE(infos[attr].num_values() == expected.num_values());
+      REQUIRE(doubled[attr].entropy() == expected.entropy());
+      REQUIRE(ds.attribute_entropy(attr) == expected.entropy());
+    }
+  }
+}
+
 // ============================================================================
 // matrix tests
 // ============================================================================
@@ -100,6 +199,70 @@ TEST_CASE("matrix input operator", "[matrix]") {
   REQUIRE(m == n);
 }
 
+TEST_CASE("matrix block parser handles missing tokens, CRLF, and block boundaries", "[matrix]") {
+  std::stringstream small("1\t-2.5\t+3\r\n\nNA\t?\t\nNaN\tnan\t.5e1\n");
+  matrix<double> m;
+  m.set_allow_missing(true);
+  small >> m;
+  REQUIRE(m.num_rows() == 3);
+  REQUIRE(m.num_columns() == 3);
+  REQUIRE(m(0, 0) == 1.0);
+  REQUIRE(m(0, 1) == -2.5);
+  REQUIRE(m(0, 2) == 3.0);
+  REQUIRE(std::isnan(m(1, 0)));
+  REQUIRE(std::isnan(m(1, 1)));
+  REQUIRE(std::isnan(m(1, 2)));
+  REQUIRE(std::isnan(m(2, 1)));
+  REQUIRE(m(2, 2) == 5.0);
+
+  // Blanks before a field are skipped, as stream extraction did.
+  for (auto [text, delimiter] : {std::pair<char const *, char>{"1, 2\n3, 4\n", ','},
+                                 {"1\t 2\n3\t 4\n", '\t'},
+                                 {" 1\t2\n 3\t4\n", '\t'}}) {
+    std::stringstream padded(text);
+    matrix<double> p;
+    p.set_delimiter(delimiter);
+    padded >> p;
+    REQUIRE(p.num_rows() == 2);
+    REQUIRE(p.num_columns() == 2);
+    REQUIRE(p(0, 1) == 2.0);
+    REQUIRE(p(1, 0) == 3.0);
+  }
+
+  // Well over one parse block, so lines straddle block boundaries; no trailing newline.
+  std::string big;
+  std::size_t rows = 200000;
+  for (std::size_t r = 0; r < rows; ++r) {
+    big += std::to_string(r) + "\t0.25\t" + std::to_string(r % 7);
+    if (r + 1 < rows) {
+      big += '\n';
+    }
+  }
+  std::stringstream big_ss(big);
+  matrix<double> b;
+  big_ss >> b;
+  REQUIRE(b.num_rows() == rows);
+  REQUIRE(b.num_columns() == 3);
+  REQUIRE(b(rows - 1, 0) == static_cast<double>(rows - 1));
+  REQUIRE(b(123456, 2) == static_cast<double>(123456 % 7));
+
+  auto parse_error = [](std::string const &text, bool allow_missing) {
+    std::stringstream ss(text);
+    matrix<double> e;
+    e.set_allow_missing(allow_missing);
+    try {
+      ss >> e;
+    } catch (std::runtime_error const &ex) {
+      return std::string(ex.what());
+    }
+    return std::string();
+  };
+  REQUIRE(parse_error("1\t2\n3\n", true) == "inconsistent number of columns at matrix row 2");
+  REQUIRE(parse_error("1\t2\n3\tabc\n", true) == "invalid value 'abc' at row 2");
+  REQUIRE(parse_error("1\t2\nNA\t2\n", false) == "invalid value 'NA' at row 2");
+  REQUIRE(parse_error("1\t2x\n", true) == "unexpected character after value at row 1");
+}
+
 TEST_CASE("matrix transpose", "[matrix]") {
   matrix<double> m(2, 3);
   m(0, 0) = 0.0;
@@ -132,6 +295,224 @@ TEST_CASE("dataset I/O roundtrip", "[dataset]") {
   REQUIRE(str == output_ss.str());
 }
 
+TEST_CASE("dataset binary save and mapped load roundtrip", "[dataset]") {
+  std::size_t n = 500;
+  std::size_t m = 7;
+  auto ds = random_dataset(n, m, 3, 5);
+  auto path = (std::filesystem::temp_directory_path() / "mrmr_test_roundtrip.mrmrbin").string();
+  ds.save_binary(path);
+  REQUIRE(is_binary_dataset(path));
+  REQUIRE(binary_dataset_value_size(path) == 1);
+
+  dataset<unsigned char> loaded;
+  {
+    // Copies share the mapping, so it must outlive the dataset it came from.
+    auto original = dataset<unsigned char>::load_binary(path);
+    loaded = original;
+  }
+  REQUIRE(loaded.num_instances() == n);
+  REQUIRE(loaded.num_attributes() == m);
+  for (std::size_t a = 0; a < m; ++a) {
+    REQUIRE(loaded.attribute_name(a) == ds.attribute_name(a));
+    REQUIRE(loaded.attribute_entropy(a) == ds.attribute_entropy(a));
+    REQUIRE(std::equal(ds.column_data(a), ds.column_data(a) + n, loaded.column_data(a)));
+    for (std::size_t b = 0; b < m; ++b) {
+      REQUIRE(loaded.mutual_information(a, b) == ds.mutual_information(a, b));
+    }
+  }
+  REQUIRE(std::get<1>(mrmr(loaded, 0)) == std::get<1>(mrmr(ds, 0)));
+
+  std::stringstream original_text;
+  std::stringstream loaded_text;
+  original_text << ds;
+  loaded_text << loaded;
+  REQUIRE(original_text.str() == loaded_text.str());
+
+  // Saving onto the mapped file replaces it without disturbing the mapping.
+  loaded.save_binary(path);
+  REQUIRE(std::get<1>(mrmr(loaded, 0)) == std::get<1>(mrmr(ds, 0)));
+  auto resaved = dataset<unsigned char>::load_binary(path);
+  REQUIRE(std::get<1>(mrmr(resaved, 0)) == std::get<1>(mrmr(ds, 0)));
+
+  // Values past an attribute's value count are rejected; the last byte is
+  // the last instance of the last attribute.
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put(static_cast<char>(250));
+  }
+  REQUIRE_THROWS_AS(dataset<unsigned char>::load_binary(path), std::runtime_error);
+
+  // Truncation and foreign files are rejected.
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  REQUIRE_THROWS_AS(dataset<unsigned char>::load_binary(path), std::runtime_error);
+  std::ofstream(path) << "class\tattr1\n0\t1\n";
+  REQUIRE_THROWS_AS(dataset<unsigned char>::load_binary(path), std::runtime_error);
+  REQUIRE(binary_dataset_value_size(path) == 0);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("dataset streaming ingestion compacts values across parse blocks", "[dataset]") {
+  // Several parse blocks of negative, offset values so provisional codes wrap.
+  std::size_t n = 80000;
+  std::size_t m = 4;
+  std::mt19937 gen(17);
+  std::uniform_real_distribution<double> dist(-1000.0, -800.0);
+  std::vector<double> values(n * m);
+  std::string text("a\tb\tc\td\n");
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    for (std::size_t attr = 0; attr < m; ++attr) {
+      double v = std::round(dist(gen) * 4.0) / 4.0 + 300.0 * static_cast<double>(attr);
+      values[inst * m + attr] = v;
+      text += std::to_string(v);
+      text += attr + 1 < m ? '\t' : '\n';
+    }
+  }
+  std::stringstream ss(text);
+  dataset<unsigned char> streamed(ss, dataset<unsigned char>::FLOOR);
+  REQUIRE(streamed.num_instances() == n);
+  for (std::size_t attr = 0; attr < m; ++attr) {
+    // Expected: floored values compacted to their rank among the distinct values.
+    std::vector<double> floored(n);
+    for (std::size_t inst = 0; inst < n; ++inst) {
+      floored[inst] = std::floor(values[inst * m + attr]);
+    }
+    std::vector<double> distinct(floored);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    std::size_t mismatches = 0;
+    for (std::size_t inst = 0; inst < n; ++inst) {
+      auto rank = std::lower_bound(distinct.begin(), distinct.end(), floored[inst]) -
+                  distinct.begin();
+      if (streamed(attr, inst) != rank) {
+        ++mismatches;
+      }
+    }
+    REQUIRE(mismatches == 0);
+  }
+
+  std::stringstream wide("a\tb\n1\t2\t3\n");
+  REQUIRE_THROWS_AS(dataset<unsigned char>(wide), std::runtime_error);
+  std::stringstream too_wide_range("a\n0\n300\n");
+  REQUIRE_THROWS_AS(dataset<unsigned char>(too_wide_range), std::runtime_error);
+}
+
+TEST_CASE("dataset parallel file loading matches the stream constructor", "[dataset]") {
+  // Several parse blocks, so the file splits into one chunk per thread. Values
+  // drift across the file, so each chunk's first values differ from the minima.
+  std::size_t n = 250000;
+  std::size_t m = 4;
+  std::mt19937 gen(29);
+  std::uniform_int_distribution<int> noise(0, 40);
+  std::string text("a\tb\tc\td\n");
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    for (std::size_t attr = 0; attr < m; ++attr) {
+      auto drift = static_cast<int>(inst * 200 / n);
+      text += inst == n / 2 && attr == 1 ? "NA" : std::to_string(noise(gen) + drift - 1000);
+      text += attr + 1 < m ? '\t' : '\n';
+    }
+  }
+  auto path = (std::filesystem::temp_directory_path() / "mrmr_test_parallel_load.tsv").string();
+  using ds_type = dataset<unsigned char>;
+  auto stream_load = [](std::string const &str, missing_strategy ms) {
+    std::stringstream ss(str);
+    return ds_type(ss, ds_type::ROUND, '\t', ms);
+  };
+
+  std::ofstream(path) << text;
+  auto loaded = ds_type::load_text(path, ds_type::ROUND, '\t', missing_strategy::PAIRWISE, 4);
+  auto streamed = stream_load(text, missing_strategy::PAIRWISE);
+  REQUIRE(loaded.num_instances() == n);
+  REQUIRE(loaded.num_attributes() == m);
+  for (std::size_t a = 0; a < m; ++a) {
+    REQUIRE(loaded.attribute_name(a) == streamed.attribute_name(a));
+    REQUIRE(loaded.attribute_entropy(a) == streamed.attribute_entropy(a));
+    REQUIRE(std::equal(streamed.column_data(a), streamed.column_data(a) + n,
+                       loaded.column_data(a)));
+  }
+
+  // Errors in later chunks report the same file rows as the sequential parse.
+  auto load_error = [&](std::string const &str) {
+    std::ofstream(path) << str;
+    std::string parallel_message;
+    std::string stream_message;
+    try {
+      ds_type::load_text(path, ds_type::ROUND, '\t', missing_strategy::PAIRWISE, 4);
+    } catch (std::runtime_error const &e) {
+      parallel_message = e.what();
+    }
+    try {
+      stream_load(str, missing_strategy::PAIRWISE);
+    } catch (std::runtime_error const &e) {
+      stream_message = e.what();
+    }
+    REQUIRE(parallel_message == stream_message);
+    return parallel_message;
+  };
+  std::size_t late_row = text.rfind('\n', text.size() - 2) + 1;
+  REQUIRE(load_error(text.substr(0, late_row) + "1\tx\t1\t1\n") ==
+          "invalid value 'x' at row " + std::to_string(n));
+  REQUIRE(load_error(text.substr(0, late_row) + "1\t1\t1\n") ==
+          "inconsistent number of columns at matrix row " + std::to_string(n));
+  REQUIRE(load_error("a\tb\n1\t2\t3\n") == "header has 2 attributes but data rows have 3 columns");
+  REQUIRE(load_error("a\tb") == "missing required newline after header");
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("dataset construction on several threads matches serial construction", "[dataset]") {
+  // More attributes and instances than one gather tile, in both layouts.
+  std::size_t n = 1000;
+  std::size_t m = 70;
+  std::mt19937 gen(31);
+  std::uniform_int_distribution<int> dist(0, 9);
+  std::vector<unsigned char> row_major(n * m);
+  std::vector<unsigned char> column_major(n * m);
+  std::string text;
+  for (std::size_t attr = 0; attr < m; ++attr) {
+    text += "attr";
+    text += std::to_string(attr);
+    text += attr + 1 < m ? '\t' : '\n';
+  }
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    for (std::size_t attr = 0; attr < m; ++attr) {
+      auto v = static_cast<unsigned char>(dist(gen) * static_cast<int>(attr % 3 + 1));
+      row_major[inst * m + attr] = v;
+      column_major[attr * n + inst] = v;
+      text += std::to_string(v);
+      text += attr + 1 < m ? '\t' : '\n';
+    }
+  }
+  using ds_type = dataset<unsigned char>;
+  ds_type serial(row_major, n, m);
+  ds_type from_rows(row_major, n, m, false, {}, ds_type::ROUND, '\t', 4);
+  ds_type from_columns(column_major, n, m, true, {}, ds_type::ROUND, '\t', 4);
+  std::stringstream ss(text);
+  ds_type streamed(ss, ds_type::ROUND, '\t', missing_strategy::ERROR, 4);
+  std::stringstream serial_ss(text);
+  ds_type streamed_serial(serial_ss);
+  for (std::size_t a = 0; a < m; ++a) {
+    for (auto const *other : {&from_rows, &from_columns}) {
+      REQUIRE(std::equal(serial.column_data(a), serial.column_data(a) + n, other->column_data(a)));
+      REQUIRE(other->attribute_entropy(a) == serial.attribute_entropy(a));
+    }
+    REQUIRE(std::equal(streamed_serial.column_data(a), streamed_serial.column_data(a) + n,
+                       streamed.column_data(a)));
+    REQUIRE(streamed.attribute_entropy(a) == streamed_serial.attribute_entropy(a));
+  }
+
+  matrix<int> wide(45, 70);
+  for (std::size_t r = 0; r < 45; ++r) {
+    for (std::size_t c = 0; c < 70; ++c) {
+      wide(r, c) = static_cast<int>(r * 70 + c);
+    }
+  }
+  matrix<int> wide_t = wide.transpose();
+  REQUIRE(wide_t.num_rows() == 70);
+  REQUIRE(wide_t.num_columns() == 45);
+  REQUIRE(wide_t.transpose() == wide);
+  REQUIRE(wide_t(69, 44) == wide(44, 69));
+}
+
 TEST_CASE("dataset attribute_entropy", "[dataset]") {
   std::string str("class\tattr1\tattr2\n0\t0\t1\n0\t1\t1\n0\t0\t0\n1\t1\t1\n1\t0\t1\n1\t1\t1\n");
   std::stringstream input_ss(str);
@@ -151,6 +532,210 @@ TEST_CASE("dataset mutual_information", "[dataset]") {
   REQUIRE_THAT(ds.mutual_information(0, 2), Catch::Matchers::WithinRel(0.1908745, 1e-5));
 }
 
+TEST_CASE("count-table MI agrees with the per-cell log2 form", "[dataset]") {
+  // Dense and sparse pairs, with and without pairwise-complete counting.
+  std::size_t n = 2000;
+  std::size_t m = 4;
+  constexpr std::array<std::size_t, 4> cards = {3, 4, 200, 150};
+  auto data = random_values(n, m, 53, [&cards](std::size_t attr) { return cards[attr]; });
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    // Attribute 1 depends on the class.
+    data[inst * m + 1] = static_cast<unsigned char>(data[inst * m + 1] + data[inst * m]);
+  }
+  dataset<unsigned char> ds(data, n, m);
+  REQUIRE(ds.xlogx() != nullptr);
+  REQUIRE(ds.xlogx()->max_count() == n);
+
+  for (std::size_t a1 = 0; a1 < m; ++a1) {
+    attribute_information<unsigned char> info1(ds.column_data(a1), ds.column_data(a1) + n);
+    for (std::size_t a2 = a1 + 1; a2 < m; ++a2) {
+      attribute_information<unsigned char> info2(ds.column_data(a2), ds.column_data(a2) + n);
+      std::size_t k1 = info1.num_values();
+      std::size_t k2 = info2.num_values();
+      std::vector<std::size_t> counts(k1 * k2, 0);
+      for (std::size_t inst = 0; inst < n; ++inst) {
+        ++counts[std::size_t{ds(a1, inst)} * k2 + ds(a2, inst)];
+      }
+      double logs = detail::mi_from_joint_histogram(counts.data(), k1, k2, info1, info2,
+                                                    unweighted_policy{});
+      double table = ds.mutual_information(a1, a2);
+      REQUIRE(std::abs(table - logs) <= detail::mi_table_tolerance);
+      REQUIRE(ds.mutual_information(a1, a2) == table);
+      // Copies share the table and reproduce the value bit for bit.
+      dataset<unsigned char> copy(ds);
+      REQUIRE(copy.xlogx() == ds.xlogx());
+      REQUIRE(copy.mutual_information(a1, a2) == table);
+
+      pairwise_complete_policy<unsigned char> pairwise(ds.column_data(a1), ds.column_data(a2));
+      REQUIRE(std::abs(compute_mi(ds, info1, info2, a1, a2, pairwise) -
+                       detail::mi_from_joint_histogram(counts.data(), k1, k2, info1, info2,
+                                                       pairwise)) <= detail::mi_table_tolerance);
+    }
+  }
+
+  // Past the size bound no table is built and MI keeps the per-cell form.
+  auto large = random_dataset(detail::xlogx_table_max_count + 1, 2, 59, 3);
+  REQUIRE(large.xlogx() == nullptr);
+  REQUIRE(large.mutual_information(0, 1) >= 0.0);
+}
+
+TEST_CASE("joint histogram kernels match scattered increments", "[dataset]") {
+  // Cardinality pairs cover the binary, compare-and-count, interleaved, and
+  // fallback kernels; n is not a multiple of the kernel block size.
+  std::size_t n = 3 * detail::joint_histogram_block + 5;
+  std::mt19937 gen(3);
+  for (auto [k1, k2] : std::vector<std::pair<std::size_t, std::size_t>>{
+           {2, 2}, {2, 3}, {3, 4}, {4, 4}, {5, 7}, {16, 16}, {17, 16}}) {
+    std::uniform_int_distribution<std::size_t> dist1(0, k1 - 1);
+    std::uniform_int_distribution<std::size_t> dist2(0, k2 - 1);
+    std::vector<unsigned char> col1(n);
+    std::vector<unsigned char> col2(n);
+    std::vector<std::size_t> expected(k1 * k2, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+      col1[i] = static_cast<unsigned char>(dist1(gen));
+      col2[i] = static_cast<unsigned char>(dist2(gen));
+      ++expected[col1[i] * k2 + col2[i]];
+    }
+    std::vector<std::size_t> actual(k1 * k2, 0);
+    detail::count_joint(col1.data(), col2.data(), n, k1, k2, actual.data());
+    REQUIRE(actual == expected);
+
+    // Narrow counters hold the same counts.
+    std::vector<std::uint16_t> narrow(k1 * k2, 0);
+    detail::count_joint(col1.data(), col2.data(), n, k1, k2, narrow.data());
+    REQUIRE(std::equal(narrow.begin(), narrow.end(), expected.begin()));
+  }
+  auto counter_size = [](std::size_t count) {
+    return detail::with_joint_counter(count, [](auto counter) { return sizeof(counter); });
+  };
+  REQUIRE(counter_size(65535) == 2);
+  REQUIRE(counter_size(65536) == 4);
+}
+
+TEST_CASE("dataset with 16-bit storage handles attributes above 255 values", "[dataset]") {
+  // Two identifier-like attributes whose joint alphabet far exceeds n (counted
+  // sparsely), a moderate one derived from the class, and the class itself.
+  std::size_t n = 3000;
+  std::size_t m = 4;
+  std::mt19937 gen(37);
+  std::uniform_int_distribution<int> ids(0, 1999);
+  std::uniform_int_distribution<int> classes(0, 2);
+  std::vector<std::uint16_t> data(n * m);
+  std::string text("class\tid1\tid2\tderived\n");
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    int cls = classes(gen);
+    std::array<int, 4> row = {cls, 40000 + ids(gen), ids(gen), cls * 300 + ids(gen) % 100};
+    for (std::size_t attr = 0; attr < m; ++attr) {
+      data[inst * m + attr] = static_cast<std::uint16_t>(row[attr]);
+      text += std::to_string(row[attr]);
+      text += attr + 1 < m ? '\t' : '\n';
+    }
+  }
+  dataset<std::uint16_t> ds(data, n, m);
+  std::stringstream ss(text);
+  dataset<std::uint16_t> streamed(ss);
+  for (std::size_t a = 0; a < m; ++a) {
+    REQUIRE(std::equal(ds.column_data(a), ds.column_data(a) + n, streamed.column_data(a)));
+  }
+  std::stringstream narrow_ss(text);
+  REQUIRE_THROWS_AS(dataset<unsigned char>(narrow_ss), std::runtime_error);
+
+  // The sparse count matches the dense histogram bit for bit.
+  attribute_information<std::uint16_t> info1(ds.column_data(1), ds.column_data(1) + n);
+  attribute_information<std::uint16_t> info2(ds.column_data(2), ds.column_data(2) + n);
+  REQUIRE(info1.num_values() > 255);
+  REQUIRE(detail::use_sparse_joint(info1.num_values(), info2.num_values(), n));
+  std::vector<std::size_t> hist(std::size_t{info1.num_values()} * info2.num_values(), 0);
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    ++hist[std::size_t{ds(1, inst)} * info2.num_values() + ds(2, inst)];
+  }
+  double dense = detail::mi_from_joint_histogram(hist.data(), info1.num_values(),
+                                                 info2.num_values(), info1, info2,
+                                                 unweighted_policy{}, ds.xlogx());
+  REQUIRE(ds.mutual_information(1, 2) == dense);
+
+  // Batched lookups route sparse pairs around the tile histograms.
+  std::vector<std::size_t> others = {0, 2, 3};
+  std::vector<double> out(others.size());
+  ds.mutual_information_batch(1, others, out);
+  for (std::size_t c = 0; c < others.size(); ++c) {
+    REQUIRE(out[c] == ds.mutual_information(1, others[c]));
+  }
+
+  auto ranking = std::get<1>(mrmr(ds, 0));
+  REQUIRE(ranking.at(1) == 3);
+}
+
+TEST_CASE("sparse joint counting matches the dense histogram", "[dataset]") {
+  // 200 x 200 cells for 3000 instances: counted through the direct-addressed
+  // table, which must be clean again for the next pair.
+  std::size_t n = 3000;
+  std::size_t m = 3;
+  auto ds = random_dataset(n, m, 71, 200);
+  std::vector<double> weights(n);
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    weights[inst] = inst % 7 == 0 ? 0.0 : 0.25 * static_cast<double>(inst % 5 + 1);
+  }
+  double total_weight = std::accumulate(weights.begin(), weights.end(), 0.0);
+  weighted_policy weighted(weights.data(), total_weight);
+
+  for (auto [a1, a2] : {std::pair<std::size_t, std::size_t>{0, 1}, {1, 2}, {2, 0}}) {
+    attribute_information<unsigned char> info1(ds.column_data(a1), ds.column_data(a1) + n);
+    attribute_information<unsigned char> info2(ds.column_data(a2), ds.column_data(a2) + n);
+    std::size_t k1 = info1.num_values();
+    std::size_t k2 = info2.num_values();
+    REQUIRE(detail::use_sparse_joint(k1, k2, n));
+    REQUIRE(k1 * k2 <= detail::sparse_direct_max_cells);
+
+    std::vector<std::size_t> counts(k1 * k2, 0);
+    std::vector<double> weighted_counts(k1 * k2, 0.0);
+    for (std::size_t inst = 0; inst < n; ++inst) {
+      std::size_t cell = std::size_t{ds(a1, inst)} * k2 + ds(a2, inst);
+      ++counts[cell];
+      weighted_counts[cell] += weights[inst];
+    }
+    REQUIRE(ds.mutual_information(a1, a2) ==
+            detail::mi_from_joint_histogram(counts.data(), k1, k2, info1, info2,
+                                            unweighted_policy{}, ds.xlogx()));
+    REQUIRE(compute_mi(ds, info1, info2, a1, a2, weighted) ==
+            detail::mi_from_joint_histogram(weighted_counts.data(), k1, k2, info1, info2,
+                                            weighted));
+  }
+}
+
+TEST_CASE("mutual_information_batch matches per-pair mutual_information", "[dataset]") {
+  // Mixed cardinalities (including a constant column) and more partners than
+  // one batch group; n spans several kernel blocks.
+  std::size_t n = 2 * detail::joint_histogram_block + 17;
+  std::size_t m = 2 * mi_batch_width + 3;
+  auto ds = random_dataset(n, m, 5,
+                           [](std::size_t attr) { return attr == 4 ? 1 : attr % 6 + 2; });
+
+  std::vector<std::size_t> others(m - 1);
+  std::iota(others.begin(), others.end(), 1);
+  std::vector<double> out(others.size());
+  ds.mutual_information_batch(0, others, out);
+  for (std::size_t c = 0; c < others.size(); ++c) {
+    REQUIRE(out[c] == ds.mutual_information(0, others[c]));
+  }
+
+  // Weighted view exercises the gathered fixed block and the weighted policy.
+  std::vector<std::size_t> instances(n);
+  std::vector<double> weights(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    instances[i] = (i * 7) % n;
+    weights[i] = 0.5 + static_cast<double>(i % 3);
+  }
+  dataset_view<unsigned char> view(ds, instances, {}, weights);
+  view.mutual_information_batch(3, others, out);
+  for (std::size_t c = 0; c < others.size(); ++c) {
+    REQUIRE(out[c] == view.mutual_information(3, others[c]));
+  }
+
+  std::vector<double> wrong_size(others.size() - 1);
+  REQUIRE_THROWS_AS(ds.mutual_information_batch(0, others, wrong_size), std::logic_error);
+}
+
 // ============================================================================
 // mRMR algorithm tests
 // ============================================================================
@@ -202,18 +787,91 @@ TEST_CASE("mrmr with all-constant attributes", "[mrmr]") {
   }
 }
 
+namespace {
+template <typename DataSource>
+concept rankable = requires(DataSource &&data) { mrmr(std::forward<DataSource>(data), 0); };
+} // namespace
+
+// Results view the data source's names, so temporary owning sources are rejected.
+static_assert(rankable<dataset<unsigned char> &>);
+static_assert(!rankable<dataset<unsigned char>>);
+static_assert(rankable<dataset_view<unsigned char>>);
+#ifdef MRMR_HAS_CONTINUOUS
+static_assert(!rankable<continuous_dataset<double>>);
+static_assert(!rankable<mixed_dataset>);
+#endif
+
 TEST_CASE("mrmr callback receives all ranks", "[mrmr]") {
   std::string str("class\tattr1\tattr2\n0\t0\t1\n0\t1\t1\n0\t0\t0\n1\t1\t1\n1\t0\t1\n1\t1\t1\n");
   std::stringstream ss(str);
   dataset<unsigned char> ds(ss, dataset<unsigned char>::ROUND);
 
   std::size_t callback_count = 0;
+  bool names_shared = true;
   auto result = mrmr(ds, 0,
-                     [&callback_count](std::size_t, std::size_t, std::string const &, double,
-                                       double, double) { ++callback_count; });
+                     [&](std::size_t, std::size_t index, std::string_view name, double, double,
+                         double) {
+                       ++callback_count;
+                       names_shared &= name.data() == ds.attribute_name(index).data();
+                     });
 
   REQUIRE(callback_count == ds.num_attributes());
   REQUIRE(std::get<0>(result).size() == ds.num_attributes());
+  // Names refer to the dataset's own strings rather than copies.
+  REQUIRE(names_shared);
+  for (std::size_t i = 0; i < std::get<1>(result).size(); ++i) {
+    std::string const &name = ds.attribute_name(std::get<1>(result)[i]);
+    REQUIRE(std::get<2>(result)[i].data() == name.data());
+    REQUIRE(std::get<2>(result)[i] == name);
+  }
+}
+
+TEST_CASE("tsv_rank_writer matches stream formatting", "[mrmr]") {
+  std::string str("class\tattr1\tattr2\n0\t0\t1\n0\t1\t1\n0\t0\t0\n1\t1\t1\n1\t0\t1\n1\t1\t1\n");
+  std::stringstream ss(str);
+  dataset<unsigned char> ds(ss, dataset<unsigned char>::ROUND);
+
+  std::ostringstream expected;
+  std::ostringstream expected_no_entropy;
+  auto reference = mrmr(ds, 0, [&](std::size_t rank, std::size_t index, std::string_view name,
+                                   double entropy, double mi, double score) {
+    expected << rank << '\t' << index << '\t' << name << '\t' << entropy << '\t' << mi << '\t'
+             << score << '\n';
+    expected_no_entropy << rank << '\t' << index << '\t' << name << '\t' << mi << '\t' << score
+                        << '\n';
+  });
+
+  std::ostringstream actual;
+  std::ostringstream actual_no_entropy;
+  {
+    tsv_rank_writer writer(actual);
+    tsv_rank_writer writer_no_entropy(actual_no_entropy, false);
+    mrmr(ds, 0, writer);
+    mrmr(ds, 0, writer_no_entropy);
+  }
+  REQUIRE(actual.str() == expected.str());
+  REQUIRE(actual_no_entropy.str() == expected_no_entropy.str());
+
+  // Extreme values format like the stream, too. With the smallest buffer,
+  // lines straddle drains and the longer name bypasses the buffer.
+  std::ostringstream extremes_expected;
+  std::ostringstream extremes_actual;
+  double const inf = std::numeric_limits<double>::infinity();
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  {
+    tsv_rank_writer writer(extremes_actual, true, std::chars_format::fixed, 3, 0);
+    extremes_expected << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < 50; ++i) {
+      std::string name(i * 20, 'x');
+      writer(i * 123456789, i, name, 1e300, -inf, i % 2 == 0 ? nan : 1e-300);
+      extremes_expected << i * 123456789 << '\t' << i << '\t' << name << '\t' << 1e300 << '\t'
+                        << -inf << '\t' << (i % 2 == 0 ? nan : 1e-300) << '\n';
+    }
+  }
+  REQUIRE(extremes_actual.str() == extremes_expected.str());
+
+  // An empty type-erased callback is not called.
+  REQUIRE(std::get<1>(mrmr(ds, 0, mrmr_rank_callback{})) == std::get<1>(reference));
 }
 
 TEST_CASE("triangular_mi_cache symmetry", "[mrmr]") {
@@ -239,6 +897,219 @@ TEST_CASE("triangular_mi_cache symmetry", "[mrmr]") {
   REQUIRE(cache.get(1, 2) == ds.mutual_information(1, 2));
 }
 
+TEST_CASE("triangular_mi_cache parallel build matches serial", "[mrmr]") {
+  std::size_t n = 500;
+  std::size_t m = 40;
+  auto ds = random_dataset(n, m, 7, 4);
+
+  std::vector<std::size_t> indices(m);
+  std::iota(indices.begin(), indices.end(), 0);
+  triangular_mi_cache<dataset<unsigned char>> serial(ds, indices, 1);
+  triangular_mi_cache<dataset<unsigned char>> parallel(ds, indices, 4);
+  for (std::size_t i = 0; i < m; ++i) {
+    for (std::size_t j = 0; j < m; ++j) {
+      REQUIRE(serial.get(i, j) == parallel.get(i, j));
+    }
+  }
+
+  auto result_serial = mrmr(ds, 0, nullptr, MRMR_DEFAULT_CACHE_THRESHOLD, 1);
+  auto result_parallel = mrmr(ds, 0, nullptr, MRMR_DEFAULT_CACHE_THRESHOLD, 4);
+  REQUIRE(std::get<1>(result_serial) == std::get<1>(result_parallel));
+}
+
+TEST_CASE("triangular_mi_cache tiled build matches per-pair MI on views", "[mrmr]") {
+  // M is not a multiple of the tile width, so edge tiles are partial.
+  std::size_t n = 700;
+  std::size_t m = mi_batch_width * 2 + 5;
+  std::mt19937 gen(13);
+  auto ds = random_dataset(n, m, 13, [](std::size_t attr) { return attr % 5 + 1; });
+  // An index view with repeated instances gathers through its indirection;
+  // a bootstrap view streams the parent's columns with multiplicities.
+  std::vector<std::size_t> sample(n);
+  for (auto &inst : sample) {
+    inst = std::uniform_int_distribution<std::size_t>(0, n - 1)(gen);
+  }
+  dataset_view<unsigned char> view(ds, sample);
+  auto counted = dataset_view<unsigned char>::bootstrap(ds, gen);
+  std::vector<double> weights(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    weights[i] = 1.0 + static_cast<double>(i % 4);
+  }
+  std::vector<std::size_t> all_instances(n);
+  std::iota(all_instances.begin(), all_instances.end(), 0);
+  dataset_view<unsigned char> weighted(ds, all_instances, {}, weights);
+
+  // Shuffled index order exercises the dense-index mapping across tiles.
+  std::vector<std::size_t> indices(m);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), gen);
+  triangular_mi_cache<dataset<unsigned char>> ds_cache(ds, indices, 3);
+  triangular_mi_cache<dataset_view<unsigned char>> view_cache(view, indices);
+  triangular_mi_cache<dataset_view<unsigned char>> counted_cache(counted, indices, 2);
+  triangular_mi_cache<dataset_view<unsigned char>> weighted_cache(weighted, indices, 2);
+  // The cache stores MI(indices[a], indices[b]) for a < b.
+  for (std::size_t a = 0; a < m; ++a) {
+    for (std::size_t b = a + 1; b < m; ++b) {
+      std::size_t i = indices[a];
+      std::size_t j = indices[b];
+      REQUIRE(ds_cache.get(i, j) == ds.mutual_information(i, j));
+      REQUIRE(view_cache.get(i, j) == view.mutual_information(i, j));
+      REQUIRE(counted_cache.get(i, j) == counted.mutual_information(i, j));
+      REQUIRE(weighted_cache.get(j, i) == weighted.mutual_information(i, j));
+    }
+  }
+}
+
+TEST_CASE("mrmr parallel on-the-fly scan matches serial including ties", "[mrmr]") {
+  // Duplicate columns produce exact score ties, exercising list-order tie-breaking.
+  std::size_t n = 300;
+  std::size_t m = 30;
+  auto data = random_values(n, m, 11, 3);
+  for (std::size_t inst = 0; inst < n; ++inst) {
+    for (std::size_t attr = 2; attr < m; attr += 3) {
+      data[inst * m + attr] = data[inst * m + attr - 1];
+    }
+  }
+  dataset<unsigned char> ds(data, n, m);
+
+  auto serial = mrmr(ds, 0, nullptr, 0, 1);
+  auto parallel = mrmr(ds, 0, nullptr, 0, 3);
+  REQUIRE(std::get<1>(serial) == std::get<1>(parallel));
+  for (std::size_t i = 1; i < std::get<5>(serial).size(); ++i) {
+    REQUIRE(std::get<5>(serial)[i] == std::get<5>(parallel)[i]);
+  }
+}
+
+TEST_CASE("mrmr_selection_loop breaks ties by candidate order", "[mrmr]") {
+  // Attributes 1..6 with equal relevance and no redundance tie at every rank,
+  // so each rank must take the earliest remaining candidate; stopping early
+  // leaves the rest in their original order.
+  for (std::size_t threads : {std::size_t{1}, std::size_t{3}}) {
+    mrmr_candidates candidates;
+    for (std::size_t attr : std::vector<std::size_t>{4, 2, 6, 1, 5, 3}) {
+      candidates.push_back(attr, 0.5);
+    }
+    std::vector<std::size_t> selected;
+    mrmr_selection_loop(
+        candidates, 0, 2, [](std::size_t, std::size_t) { return 0.0; },
+        [&selected](std::size_t, std::size_t attr, double score) {
+          REQUIRE(score == 0.5);
+          selected.push_back(attr);
+        },
+        threads, 4);
+    REQUIRE(selected == std::vector<std::size_t>{4, 2, 6});
+    REQUIRE(candidates.attributes == std::vector<std::size_t>{1, 5, 3});
+    REQUIRE(candidates.relevance == std::vector<double>{0.5, 0.5, 0.5});
+  }
+}
+
+TEST_CASE("mrmr max_features stops after the top k selections", "[mrmr]") {
+  std::size_t n = 300;
+  std::size_t m = 24;
+  // The last two attributes are constant and must still be reported.
+  auto ds = random_dataset(n, m, 5, [m](std::size_t attr) { return attr >= m - 2 ? 1 : 4; });
+
+  for (std::size_t threshold : {std::size_t{10000}, std::size_t{0}}) {
+    auto full = mrmr(ds, 0, nullptr, threshold);
+    auto top = mrmr(ds, 0, nullptr, threshold, 1, 5);
+    auto const &ranks = std::get<0>(top);
+    auto const &indices = std::get<1>(top);
+    // Class, five selections, then both constant attributes.
+    REQUIRE(ranks.size() == 8);
+    for (std::size_t i = 0; i <= 5; ++i) {
+      REQUIRE(ranks[i] == i);
+      REQUIRE(indices[i] == std::get<1>(full)[i]);
+      if (i > 0) {
+        REQUIRE(std::get<5>(top)[i] == std::get<5>(full)[i]);
+      }
+    }
+    REQUIRE(ranks[6] == 6);
+    REQUIRE(indices[6] == m - 2);
+    REQUIRE(ranks[7] == 7);
+    REQUIRE(indices[7] == m - 1);
+
+    // A limit above the number of useful attributes ranks everything.
+    REQUIRE(std::get<1>(mrmr(ds, 0, nullptr, threshold, 1, m)) == std::get<1>(full));
+  }
+}
+
+TEST_CASE("plan_mrmr_mi picks the cheaper pairwise MI strategy", "[mrmr]") {
+  // Full ranking: equal pair counts, the triangle wins.
+  auto full = plan_mrmr_mi(1000, 100000, 0, MRMR_DEFAULT_CACHE_THRESHOLD);
+  REQUIRE(full.strategy == mrmr_mi_strategy::TRIANGULAR);
+  REQUIRE(full.num_selected == 1000);
+  REQUIRE(full.triangular_pairs == 499500);
+  REQUIRE(full.on_demand_pairs == 499500);
+
+  // Top 50 of 1000: 49 rows are far cheaper than the triangle.
+  auto top = plan_mrmr_mi(1000, 100000, 50, MRMR_DEFAULT_CACHE_THRESHOLD);
+  REQUIRE(top.strategy == mrmr_mi_strategy::ON_DEMAND);
+  REQUIRE(top.on_demand_pairs == 49 * 1000 - 50 * 49 / 2);
+
+  // With very few instances the per-rank overhead favors the triangle.
+  REQUIRE(plan_mrmr_mi(1000, 2, 900, MRMR_DEFAULT_CACHE_THRESHOLD).strategy ==
+          mrmr_mi_strategy::TRIANGULAR);
+
+  // Above the threshold the triangle is never built; one feature needs no pairs.
+  REQUIRE(plan_mrmr_mi(1000, 100000, 0, 999).strategy == mrmr_mi_strategy::ON_DEMAND);
+  REQUIRE(plan_mrmr_mi(1000, 100000, 1, MRMR_DEFAULT_CACHE_THRESHOLD).strategy ==
+          mrmr_mi_strategy::NONE);
+  REQUIRE(plan_mrmr_mi(0, 100000, 0, MRMR_DEFAULT_CACHE_THRESHOLD).strategy ==
+          mrmr_mi_strategy::NONE);
+}
+
+TEST_CASE("mrmr top-k on demand matches the on-the-fly ranking", "[mrmr]") {
+  std::size_t n = 4000;
+  std::size_t m = 40;
+  auto ds = random_dataset(n, m, 9, 3);
+
+  auto plan = plan_mrmr(ds, 0, MRMR_DEFAULT_CACHE_THRESHOLD, 4);
+  REQUIRE(plan.num_useful == m - 1);
+  REQUIRE(plan.strategy == mrmr_mi_strategy::ON_DEMAND);
+  REQUIRE(plan_mrmr(ds, 0).strategy == mrmr_mi_strategy::TRIANGULAR);
+
+  auto top = mrmr(ds, 0, nullptr, MRMR_DEFAULT_CACHE_THRESHOLD, 1, 4);
+  auto reference = mrmr(ds, 0, nullptr, 0);
+  REQUIRE(std::get<1>(top).size() == 5);
+  for (std::size_t i = 0; i < 5; ++i) {
+    REQUIRE(std::get<1>(top)[i] == std::get<1>(reference)[i]);
+    if (i > 0) {
+      REQUIRE(std::get<5>(top)[i] == std::get<5>(reference)[i]);
+    }
+  }
+}
+
+TEST_CASE("lazy_mi_cache reuses rows within its byte budget", "[mrmr]") {
+  std::size_t n = 200;
+  std::size_t m = 12;
+  auto ds = random_dataset(n, m, 17, 3);
+  std::vector<std::size_t> indices(m);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::vector<std::size_t> others(indices.begin() + 1, indices.end());
+  std::vector<double> out(others.size());
+
+  lazy_mi_cache<dataset<unsigned char>> cache(ds, indices, 2 * m * sizeof(double));
+  cache(0, others, out);
+  for (std::size_t c = 0; c < others.size(); ++c) {
+    REQUIRE(out[c] == ds.mutual_information(0, others[c]));
+  }
+  REQUIRE(cache.computed_pairs() == others.size());
+  cache(0, others, out);
+  REQUIRE(cache(0, 5) == ds.mutual_information(0, 5));
+  REQUIRE(cache.computed_pairs() == others.size());
+
+  // Third row exceeds the two-row budget: the least recently used row goes.
+  REQUIRE(cache(1, 2) == ds.mutual_information(1, 2));
+  REQUIRE(cache(2, 1) == ds.mutual_information(2, 1));
+  REQUIRE(cache.cached_rows() == 2);
+  REQUIRE(cache(0, 5) == ds.mutual_information(0, 5));
+  REQUIRE(cache.computed_pairs() == others.size() + 3);
+
+  lazy_mi_cache<dataset<unsigned char>> disabled(ds, indices, 0);
+  REQUIRE(disabled(0, 5) == ds.mutual_information(0, 5));
+  REQUIRE(disabled.cached_rows() == 0);
+}
+
 // ============================================================================
 // mRMRe ensemble tests
 // ============================================================================
@@ -265,6 +1136,122 @@ TEST_CASE("mrmre exhaustive produces multiple solutions", "[mrmre]") {
   REQUIRE(result.feature_frequencies.size() == ds.num_attributes());
 }
 
+TEST_CASE("mrmre exhaustive lazy row cache matches on-the-fly", "[mrmre]") {
+  std::size_t n = 300;
+  std::size_t m = 25;
+  auto ds = random_dataset(n, m, 19, 4);
+
+  // cache_threshold 0 forces the large-M path; budget 0 disables the lazy cache.
+  auto lazy = mrmre(ds, 0, 6, 5, mrmre_method::EXHAUSTIVE, 42, 0, 2);
+  auto plain = mrmre(ds, 0, 6, 5, mrmre_method::EXHAUSTIVE, 42, 0, 2, 0);
+  REQUIRE(lazy.solutions.size() == plain.solutions.size());
+  for (std::size_t s = 0; s < lazy.solutions.size(); ++s) {
+    REQUIRE(lazy.solutions[s].selected_indices == plain.solutions[s].selected_indices);
+    REQUIRE(lazy.solutions[s].scores == plain.solutions[s].scores);
+  }
+  REQUIRE(lazy.consensus_ranking == plain.consensus_ranking);
+}
+
+TEST_CASE("mrmre exhaustive lockstep matches independent selection loops", "[mrmre]") {
+  // Few instances and binary values make many MI values tie.
+  std::size_t n = 24;
+  std::size_t m = 16;
+  auto ds = random_dataset(n, m, 5, 2);
+
+  std::vector<std::pair<double, std::size_t>> mi_ranked;
+  for (std::size_t a = 1; a < m; ++a) {
+    if (ds.attribute_entropy(a) > 0) {
+      mi_ranked.emplace_back(ds.mutual_information(0, a), a);
+    }
+  }
+  std::stable_sort(mi_ranked.begin(), mi_ranked.end(),
+                   [](auto const &a, auto const &b) { return a.first > b.first; });
+  REQUIRE(mi_ranked.size() > 4);
+  std::size_t num_solutions = 5;
+
+  for (std::size_t feature_count : {std::size_t{1}, std::size_t{4}, mi_ranked.size()}) {
+    std::vector<mrmre_solution> expected(num_solutions);
+    detail::on_the_fly_mi<dataset<unsigned char>> get_mi(ds);
+    for (std::size_t s = 0; s < num_solutions; ++s) {
+      expected[s].selected_indices.push_back(mi_ranked[s].second);
+      expected[s].scores.push_back(mi_ranked[s].first);
+      mrmr_candidates candidates;
+      for (auto const &pair : mi_ranked) {
+        if (pair.second != mi_ranked[s].second) {
+          candidates.push_back(pair.second, pair.first);
+        }
+      }
+      mrmr_selection_loop(
+          candidates, mi_ranked[s].second, 2, get_mi,
+          [&](std::size_t, std::size_t attr, double score) {
+            expected[s].selected_indices.push_back(attr);
+            expected[s].scores.push_back(score);
+          },
+          1, feature_count);
+    }
+
+    // State bounds of one solution, two solutions, and all at once.
+    std::size_t per_solution = 4 * sizeof(std::size_t) * mi_ranked.size();
+    for (std::size_t state_bytes :
+         {std::size_t{0}, 2 * per_solution, detail::lockstep_state_bytes}) {
+      for (std::size_t threads : {std::size_t{1}, std::size_t{3}}) {
+        auto per_pair = [&ds](std::size_t a1, std::size_t a2) {
+          return ds.mutual_information(a1, a2);
+        };
+        auto lockstep = detail::exhaustive_lockstep(mi_ranked, num_solutions, feature_count,
+                                                    per_pair, threads, state_bytes);
+        auto batched = detail::exhaustive_lockstep(mi_ranked, num_solutions, feature_count,
+                                                   get_mi, threads, state_bytes);
+        REQUIRE(lockstep.size() == num_solutions);
+        for (std::size_t s = 0; s < num_solutions; ++s) {
+          REQUIRE(lockstep[s].selected_indices == expected[s].selected_indices);
+          REQUIRE(lockstep[s].scores == expected[s].scores);
+          REQUIRE(batched[s].selected_indices == expected[s].selected_indices);
+          REQUIRE(batched[s].scores == expected[s].scores);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("mrmre solutions do not depend on the thread count", "[mrmre]") {
+  std::size_t n = 200;
+  std::size_t m = 20;
+  auto ds = random_dataset(n, m, 23, 3);
+
+  for (auto method : {mrmre_method::EXHAUSTIVE, mrmre_method::BOOTSTRAP}) {
+    for (std::size_t threshold : {std::size_t{0}, MRMR_DEFAULT_CACHE_THRESHOLD}) {
+      auto serial = mrmre(ds, 0, 5, 6, method, 7, threshold, 1);
+      auto parallel = mrmre(ds, 0, 5, 6, method, 7, threshold, 4);
+      REQUIRE(serial.solutions.size() == 6);
+      REQUIRE(parallel.solutions.size() == serial.solutions.size());
+      for (std::size_t s = 0; s < serial.solutions.size(); ++s) {
+        REQUIRE(parallel.solutions[s].selected_indices == serial.solutions[s].selected_indices);
+        REQUIRE(parallel.solutions[s].scores == serial.solutions[s].scores);
+      }
+      REQUIRE(parallel.consensus_ranking == serial.consensus_ranking);
+      REQUIRE(parallel.feature_frequencies == serial.feature_frequencies);
+    }
+  }
+}
+
+TEST_CASE("mrmre bootstrap solutions are the top of each resample's full ranking", "[mrmre]") {
+  std::size_t n = 200;
+  std::size_t m = 20;
+  auto ds = random_dataset(n, m, 29, 3);
+
+  // Solutions stop their rankings after feature_count selections.
+  auto result = mrmre(ds, 0, 4, 3, mrmre_method::BOOTSTRAP, 11);
+  REQUIRE(result.solutions.size() == 3);
+  for (std::size_t s = 0; s < result.solutions.size(); ++s) {
+    std::mt19937 gen = detail::bootstrap_generator(11, s);
+    auto sample = bootstrap_resample(ds, gen);
+    auto full = extract_solution(mrmr(sample, 0), 4);
+    REQUIRE(result.solutions[s].selected_indices == full.selected_indices);
+    REQUIRE(result.solutions[s].scores == full.scores);
+  }
+}
+
 TEST_CASE("mrmre exhaustive consensus ranks frequent features first", "[mrmre]") {
   std::string str("class\tattr1\tattr2\n0\t0\t1\n0\t1\t1\n0\t0\t0\n1\t1\t1\n1\t0\t1\n1\t1\t1\n");
   std::stringstream ss(str);
@@ -299,6 +1286,85 @@ TEST_CASE("mrmr on bootstrap view produces valid ranking", "[mrmre]") {
   REQUIRE(indices[0] == 0); // class attribute index
 }
 
+TEST_CASE("dataset_view MI matches per-instance evaluation through operator()", "[mrmre]") {
+  std::size_t n = 500;
+  std::size_t m = 5;
+  auto ds = random_dataset(n, m, 37, 5);
+
+  std::vector<std::size_t> instances(n);
+  std::vector<double> weights(n);
+  double total_weight = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    instances[i] = (i * 13) % n;
+    weights[i] = 0.25 + static_cast<double>(i % 5);
+    total_weight += weights[i];
+  }
+  dataset_view<unsigned char> plain(ds, instances, {4, 0, 2});
+  dataset_view<unsigned char> weighted(ds, instances, {4, 0, 2}, weights);
+  std::vector<std::size_t> source_attr{4, 0, 2};
+
+  for (std::size_t a = 0; a < 3; ++a) {
+    for (std::size_t b = 0; b < 3; ++b) {
+      unsigned char const *col_a = ds.column_data(source_attr[a]);
+      unsigned char const *col_b = ds.column_data(source_attr[b]);
+      attribute_information<unsigned char> info_a(col_a, col_a + n);
+      attribute_information<unsigned char> info_b(col_b, col_b + n);
+      // The views themselves have no column accessors, so compute_mi reads
+      // them through operator().
+      REQUIRE(plain.mutual_information(a, b) ==
+              compute_mi(plain, info_a, info_b, a, b, unweighted_policy{}));
+      REQUIRE(weighted.mutual_information(a, b) ==
+              compute_mi(weighted, info_a, info_b, a, b,
+                         weighted_policy{weights.data(), total_weight}));
+    }
+  }
+}
+
+TEST_CASE("count-weighted bootstrap view matches the listed sample", "[mrmre]") {
+  std::size_t n = 600;
+  std::size_t m = 6;
+  // Attribute 5 has more joint cells with attribute 4 than instances,
+  // exercising the sparse joint path.
+  auto ds = random_dataset(n, m, 31, [](std::size_t attr) { return attr >= 4 ? 40 : attr + 2; });
+
+  for (bool stratified : {false, true}) {
+    std::mt19937 sample_gen(7);
+    auto view = stratified ? dataset_view<unsigned char>::stratified_bootstrap(ds, 0, sample_gen)
+                           : dataset_view<unsigned char>::bootstrap(ds, sample_gen);
+    REQUIRE(view.num_instances() == n);
+
+    // The same sample as an index view listing each instance count times.
+    std::vector<std::size_t> listed;
+    for (std::size_t i = 0; i < n; ++i) {
+      listed.insert(listed.end(), view.instance_count(i), i);
+    }
+    REQUIRE(listed.size() == n);
+    dataset_view<unsigned char> index_view(ds, listed);
+
+    for (std::size_t a = 0; a < m; ++a) {
+      REQUIRE(view.attribute_entropy(a) == index_view.attribute_entropy(a));
+      for (std::size_t b = 0; b < m; ++b) {
+        REQUIRE(view.mutual_information(a, b) == index_view.mutual_information(a, b));
+      }
+    }
+    std::vector<std::size_t> others{1, 2, 3, 4, 5};
+    std::vector<double> out(others.size());
+    view.mutual_information_batch(0, others, out);
+    for (std::size_t c = 0; c < others.size(); ++c) {
+      REQUIRE(out[c] == index_view.mutual_information(0, others[c]));
+    }
+  }
+
+  std::vector<dataset_view<unsigned char>::instance_count_type> counts(n, 0);
+  counts[3] = 2;
+  counts[8] = 1;
+  auto counted = dataset_view<unsigned char>::from_counts(ds, counts, {1, 2});
+  REQUIRE(counted.num_attributes() == 2);
+  REQUIRE(counted.instance_count(3) == 2);
+  REQUIRE(counted(1, 8) == ds(2, 8));
+  REQUIRE_THROWS_AS(dataset_view<unsigned char>::from_counts(ds, {1, 2}), std::logic_error);
+}
+
 // ============================================================================
 // Missing value tests
 // ============================================================================
@@ -475,6 +1541,21 @@ TEST_CASE("mixed_dataset MI dispatch: DD, CC, DC pairs", "[mixed]") {
   REQUIRE(dc_mi >= 0.0);
 }
 
+TEST_CASE("mixed_dataset mutual_information_batch matches per-pair MI", "[mixed]") {
+  std::string str("class:discrete\td:discrete\tc:continuous\te:discrete\n"
+                  "0\t0\t1.0\t2\n0\t1\t1.5\t0\n0\t0\t0.5\t1\n"
+                  "1\t1\t3.0\t2\n1\t0\t3.5\t2\n1\t1\t2.5\t0\n");
+  std::stringstream ss(str);
+  mixed_dataset ds(ss);
+
+  std::vector<std::size_t> others{1, 2, 3};
+  std::vector<double> out(others.size());
+  ds.mutual_information_batch(0, others, out);
+  for (std::size_t c = 0; c < others.size(); ++c) {
+    REQUIRE(out[c] == ds.mutual_information(0, others[c]));
+  }
+}
+
 TEST_CASE("mrmr works with mixed_dataset", "[mixed]") {
   std::string str("class:discrete\td:discrete\tc:continuous\n"
                   "0\t0\t1.0\n0\t1\t1.5\n0\t0\t0.5\n"
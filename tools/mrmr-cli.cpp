@@ -15,6 +15,7 @@
 #include <mrmr/missing.hpp>
 #include <mrmr/mrmr.hpp>
 #include <mrmr/mrmre.hpp>
+#include <mrmr/rank_writer.hpp>
 #ifdef MRMR_HAS_CONTINUOUS
 #include <mrmr/continuous_dataset.hpp>
 #include <mrmr/mixed_dataset.hpp>
@@ -55,16 +56,27 @@ static void usage(char const *program) {
 #endif
   std::cerr << "      --missing=STRATEGY     {error,pairwise,impute-mode,impute-median,\n";
   std::cerr << "                              impute-mean} (default: error)\n";
+  std::cerr << "      --wide                 16-bit storage: attribute ranges up to 65535\n";
+  std::cerr << "                             instead of 255\n";
+  std::cerr << "\n";
+  std::cerr << "Performance options:\n";
+  std::cerr << "  -j, --threads=NUM          worker threads for parsing and MI computation\n";
+  std::cerr << "                             (default: 0 = all cores)\n";
+  std::cerr << "\n";
+  std::cerr << "Ranking options:\n";
+  std::cerr << "  -k, --features=NUM         rank only the top NUM features (default: all);\n";
+  std::cerr << "                             features per solution in ensemble mode\n";
   std::cerr << "\n";
   std::cerr << "Ensemble options (mRMRe):\n";
   std::cerr << "  -e, --ensemble=METHOD      {exhaustive,bootstrap} — enable ensemble mode\n";
   std::cerr << "  -n, --solutions=NUM        ensemble solutions (default: 10)\n";
-  std::cerr << "  -k, --features=NUM         features per solution (default: all)\n";
   std::cerr << "  -s, --seed=NUM             random seed for bootstrap (default: 42)\n";
   std::cerr << "\n";
   std::cerr << "Output options:\n";
   std::cerr << "  -w, --write-data           output parsed/discretized data and exit\n";
   std::cerr << "  -i, --info                 show dataset summary and exit\n";
+  std::cerr << "      --save-binary=FILE     save discretized data in binary form and exit;\n";
+  std::cerr << "                             binary input files are memory-mapped\n";
   std::cerr << "  -v, --verbosity=VALUE      {0,1,2,3,quiet,warning,info,debug} (default: 1)\n";
   std::cerr << "\n";
   std::cerr << "General:\n";
@@ -108,8 +120,21 @@ static bool parse_ulong(char const *optarg_str, unsigned long &out) {
   return endptr != optarg_str && *endptr == '\0' && errno != ERANGE;
 }
 
+// Helper: describe the pairwise MI strategy mrmr() is about to use.
+static std::string describe_plan(mrmr_plan const &plan) {
+  switch (plan.strategy) {
+  case mrmr_mi_strategy::TRIANGULAR:
+    return "MI strategy: triangular cache (" + std::to_string(plan.triangular_pairs) + " pairs)";
+  case mrmr_mi_strategy::ON_DEMAND:
+    return "MI strategy: on-demand rows (" + std::to_string(plan.on_demand_pairs) + " pairs)";
+  case mrmr_mi_strategy::NONE:
+    break;
+  }
+  return "MI strategy: none (fewer than two features to rank)";
+}
+
 // Long option indices for options without short flags
-enum : std::uint16_t { OPT_KSG_K = 256, OPT_MISSING };
+enum : std::uint16_t { OPT_KSG_K = 256, OPT_MISSING, OPT_SAVE_BINARY, OPT_WIDE };
 
 int main(int argc, char *argv[]) try {
   std::cout << std::scientific;
@@ -124,6 +149,9 @@ int main(int argc, char *argv[]) try {
   bool just_write = false;
   bool show_info = false;
   char delimiter = '\t';
+  char const *input_path = nullptr;
+  char const *save_binary_path = nullptr;
+  bool wide_values = false;
 
   // Method selection
   enum class mi_method : std::uint8_t { DISCRETE, CONTINUOUS };
@@ -144,6 +172,9 @@ int main(int argc, char *argv[]) try {
   std::size_t feature_count = 0;
   unsigned ensemble_seed = 42;
 
+  // Parallelism (0 = hardware concurrency)
+  std::size_t num_threads = 0;
+
   static struct option long_options[] = {
       {.name = "delimiter", .has_arg = required_argument, .flag = nullptr, .val = 't'},
       {.name = "class", .has_arg = required_argument, .flag = nullptr, .val = 'c'},
@@ -151,20 +182,26 @@ int main(int argc, char *argv[]) try {
       {.name = "discretize", .has_arg = required_argument, .flag = nullptr, .val = 'd'},
       {.name = "ksg-k", .has_arg = required_argument, .flag = nullptr, .val = OPT_KSG_K},
       {.name = "missing", .has_arg = required_argument, .flag = nullptr, .val = OPT_MISSING},
+      {.name = "wide", .has_arg = no_argument, .flag = nullptr, .val = OPT_WIDE},
       {.name = "verbosity", .has_arg = required_argument, .flag = nullptr, .val = 'v'},
       {.name = "write-data", .has_arg = no_argument, .flag = nullptr, .val = 'w'},
       {.name = "info", .has_arg = no_argument, .flag = nullptr, .val = 'i'},
+      {.name = "save-binary",
+       .has_arg = required_argument,
+       .flag = nullptr,
+       .val = OPT_SAVE_BINARY},
       {.name = "ensemble", .has_arg = required_argument, .flag = nullptr, .val = 'e'},
       {.name = "solutions", .has_arg = required_argument, .flag = nullptr, .val = 'n'},
       {.name = "features", .has_arg = required_argument, .flag = nullptr, .val = 'k'},
       {.name = "seed", .has_arg = required_argument, .flag = nullptr, .val = 's'},
+      {.name = "threads", .has_arg = required_argument, .flag = nullptr, .val = 'j'},
       {.name = "help", .has_arg = no_argument, .flag = nullptr, .val = 'h'},
       {.name = "version", .has_arg = no_argument, .flag = nullptr, .val = 'V'},
       {.name = nullptr, .has_arg = 0, .flag = nullptr, .val = 0}};
 
   int c;
   int option_index = 0;
-  while ((c = getopt_long(argc, argv, "t:c:m:d:v:wie:n:k:s:hV", long_options, &option_index)) !=
+  while ((c = getopt_long(argc, argv, "t:c:m:d:v:wie:n:k:s:j:hV", long_options, &option_index)) !=
          -1) {
     switch (c) {
     case 't':
@@ -251,6 +288,9 @@ int main(int argc, char *argv[]) try {
         return 1;
       }
       break;
+    case OPT_WIDE:
+      wide_values = true;
+      break;
     case 'v':
       if (strcmp(optarg, "0") == 0 || strcmp(optarg, "quiet") == 0) {
         VERBOSITY = QUIET;
@@ -273,6 +313,9 @@ int main(int argc, char *argv[]) try {
     case 'i':
       show_info = true;
       break;
+    case OPT_SAVE_BINARY:
+      save_binary_path = optarg;
+      break;
     case 'e':
       ensemble_mode = true;
       if (strcmp(optarg, "exhaustive") == 0) {
@@ -308,6 +351,14 @@ int main(int argc, char *argv[]) try {
       }
       ensemble_seed = static_cast<unsigned>(val);
     } break;
+    case 'j': {
+      unsigned long val;
+      if (!parse_ulong(optarg, val)) {
+        std::cerr << argv[0] << ": -j --threads  must be a non-negative integer\n";
+        return 1;
+      }
+      num_threads = val;
+    } break;
     case 'h':
       usage(argv[0]);
       return 0;
@@ -330,12 +381,17 @@ int main(int argc, char *argv[]) try {
     std::cerr << argv[0] << ": --ksg-k is only used with --method=continuous\n";
     return 1;
   }
+  if (method == mi_method::CONTINUOUS && wide_values) {
+    std::cerr << argv[0] << ": --wide is only used with --method=discrete\n";
+    return 1;
+  }
 #endif
 
   // Open file if specified
   if (optind < argc) {
     if (optind == argc - 1) {
-      ifs = std::ifstream(argv[optind]);
+      input_path = argv[optind];
+      ifs = std::ifstream(input_path);
       if (!ifs.is_open()) {
         std::cerr << argv[0] << ": " << argv[optind] << ": No such file or directory\n";
         return 1;
@@ -350,19 +406,33 @@ int main(int argc, char *argv[]) try {
 
   std::istream &input = ifs.is_open() ? ifs : std::cin;
 
+  // Binary datasets written by --save-binary are memory-mapped instead of parsed.
+  bool binary_input = input_path != nullptr && is_binary_dataset(input_path);
+
   // --- Discrete method (default) ---
-  if (method == mi_method::DISCRETE) {
-    log_message("Reading and transforming dataset...", INFO, START);
-    dataset_type data;
+  // The storage type is chosen at run time; the pipeline is instantiated for both.
+  auto run_discrete = [&](auto storage) -> int {
+    log_message(binary_input ? "Mapping binary dataset..." : "Reading and transforming dataset...",
+                INFO, START);
+    using discrete_dataset = dataset<decltype(storage)>;
+    auto dm = static_cast<typename discrete_dataset::discretization_method>(discretize);
+    discrete_dataset data;
     try {
-      data = dataset_type(input, discretize, delimiter, missing);
+      // A named file is parsed on all -j threads; stdin is parsed sequentially.
+      if (binary_input) {
+        data = discrete_dataset::load_binary(input_path);
+      } else if (input_path != nullptr) {
+        data = discrete_dataset::load_text(input_path, dm, delimiter, missing, num_threads);
+      } else {
+        data = discrete_dataset(input, dm, delimiter, missing, num_threads);
+      }
     } catch (std::exception const &e) {
       std::cerr << argv[0] << ": " << e.what() << "\n";
       return 2;
     }
     log_message("DONE", INFO, FINISH);
 
-    if (!discretization_chosen) {
+    if (!discretization_chosen && !binary_input) {
       log_message("No discretization method chosen. Default 'truncate' used...", WARNING, STANDARD);
     }
 
@@ -386,6 +456,16 @@ int main(int argc, char *argv[]) try {
       return 0;
     }
 
+    if (save_binary_path != nullptr) {
+      try {
+        data.save_binary(save_binary_path);
+      } catch (std::exception const &e) {
+        std::cerr << argv[0] << ": " << e.what() << "\n";
+        return 2;
+      }
+      return 0;
+    }
+
     // Standard or ensemble mRMR on discrete data
     if (ensemble_mode) {
       if (feature_count == 0) {
@@ -393,7 +473,7 @@ int main(int argc, char *argv[]) try {
       }
       log_message("Computing mRMRe ensemble...", INFO, START);
       auto result = mrmre(data, class_attribute, feature_count, solution_count, ensemble_method,
-                          ensemble_seed);
+                          ensemble_seed, MRMR_DEFAULT_CACHE_THRESHOLD, num_threads);
       log_message("DONE", INFO, FINISH);
 
       std::cout << "# Consensus Ranking\n";
@@ -411,23 +491,36 @@ int main(int argc, char *argv[]) try {
                   << freq << '\n';
       }
     } else {
+      log_message(describe_plan(plan_mrmr(data, class_attribute, MRMR_DEFAULT_CACHE_THRESHOLD,
+                                          feature_count))
+                      .c_str(),
+                  INFO, STANDARD);
       log_message("Computing mRMR feature ranking...", INFO, START);
       std::cout << "Rank\tIndex\tName\tEntropy\tMutual Information\tmRMR Score\n";
-      mrmr(data, class_attribute,
-           [](std::size_t rank, std::size_t index, std::string const &name, double entropy,
-              double mi, double score) {
-             std::cout << rank << '\t' << index << '\t' << name << '\t' << entropy << '\t' << mi
-                       << '\t' << score << '\n';
-           });
+      tsv_rank_writer writer(std::cout, true, std::chars_format::scientific);
+      mrmr(data, class_attribute, writer, MRMR_DEFAULT_CACHE_THRESHOLD, num_threads,
+           feature_count);
+      writer.flush();
       log_message("DONE", INFO, FINISH);
     }
 
     return 0;
+  };
+  if (method == mi_method::DISCRETE) {
+    // Binary input is loaded with the value width it was saved with.
+    bool wide_storage = binary_input
+                            ? binary_dataset_value_size(input_path) == sizeof(std::uint16_t)
+                            : wide_values;
+    return wide_storage ? run_discrete(std::uint16_t{}) : run_discrete(storage_type{});
   }
 
 #ifdef MRMR_HAS_CONTINUOUS
   // --- Continuous/mixed method ---
   if (method == mi_method::CONTINUOUS) {
+    if (binary_input || save_binary_path != nullptr) {
+      std::cerr << argv[0] << ": binary datasets are only supported with --method=discrete\n";
+      return 1;
+    }
     log_message("Reading dataset (continuous/mixed mode)...", INFO, START);
     mixed_dataset data;
     try {
@@ -463,7 +556,7 @@ int main(int argc, char *argv[]) try {
       log_message("Computing mRMRe ensemble (continuous)...", INFO, START);
       try {
         auto result = mrmre(data, class_attribute, feature_count, solution_count, ensemble_method,
-                            ensemble_seed);
+                            ensemble_seed, MRMR_DEFAULT_CACHE_THRESHOLD, num_threads);
         log_message("DONE", INFO, FINISH);
 
         std::cout << "# Consensus Ranking\n";
@@ -487,14 +580,15 @@ int main(int argc, char *argv[]) try {
       return 0;
     }
 
+    log_message(describe_plan(plan_mrmr(data, class_attribute, MRMR_DEFAULT_CACHE_THRESHOLD,
+                                        feature_count))
+                    .c_str(),
+                INFO, STANDARD);
     log_message("Computing mRMR feature ranking (KSG MI)...", INFO, START);
     std::cout << "Rank\tIndex\tName\tMI(class)\tmRMR Score\n";
-    mrmr(data, class_attribute,
-         [](std::size_t rank, std::size_t index, std::string const &name, double /*entropy*/,
-            double mi, double score) {
-           std::cout << rank << '\t' << index << '\t' << name << '\t' << mi << '\t' << score
-                     << '\n';
-         });
+    tsv_rank_writer writer(std::cout, false, std::chars_format::scientific);
+    mrmr(data, class_attribute, writer, MRMR_DEFAULT_CACHE_THRESHOLD, num_threads, feature_count);
+    writer.flush();
     log_message("DONE", INFO, FINISH);
 
     return 0;